@@ -4,10 +4,12 @@
 #define _ARRAY_H_
 
 #include <algorithm>
+#include <iterator>  // reverse_iterator.
+#include <stdexcept> // out_of_range.
 
 const std::size_t DEFAULT_SIZE { 16 };
 
-template<class T, std::size_t N = DEFUALT_SIZE>
+template<class T, std::size_t N = DEFAULT_SIZE>
 class Array
 {
 public:
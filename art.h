@@ -0,0 +1,965 @@
+/*************************************************************************
+* Title: Adaptive Radix Tree Set
+* File: art.h
+* Date: 10/18/2026
+*
+* Ordered set on an adaptive radix tree (Leis, Kemper & Neumann). Keys
+* are turned into byte strings that sort like the keys, then descended a
+* byte per level, so a lookup costs at most one node per key byte no
+* matter how many keys are stored. Exposes the set<T> operations:
+*
+*   insert(T)     // insert T, returns false if T already present.
+*   add(T)        // same as insert, tree<T> naming.
+*   remove(T)     // remove T, returns true if T was present.
+*   search(T)     // returns true if T is present.
+*   clear()       // deletes all keys.
+*   empty()       // returns true if set is empty.
+*   size()        // number of keys, O(1).
+*   lowerBound()  // smallest key.
+*   upperBound()  // largest key.
+*   lowerBound(T) // iterator to first key not less than T.
+*   begin()/end() // in-order forward iteration.
+*
+* Notes:
+*  (1) Inner nodes come in four sizes, growing and shrinking with their
+*      child count: node4 and node16 (sorted key bytes and children),
+*      node48 (256 entry byte index into 48 children) and node256 (direct
+*      child array).
+*  (2) Paths with a single child are compressed into the node below. Up
+*      to MAX_PREFIX bytes of the compressed path are kept in the node,
+*      longer paths are checked optimistically and confirmed at the leaf.
+*  (3) artKey<T> maps keys to bytes: integers big-endian with the sign
+*      bit flipped, strings with 0x00 escaped as 0x00 0xFF and terminated
+*      by 0x00 0x00. Encoded keys never prefix one another. Other key
+*      types can be supported by specializing artKey.
+*************************************************************************
+* Change Log:
+*  10/18/2026: Initial release.
+*  10/18/2026: node16 key bytes are searched with SIMD compares.
+*************************************************************************/
+#ifndef _ART_H_
+#define _ART_H_
+
+#include <cstdint>     // fixed width node fields.
+#include <cstring>     // memcpy, memmove.
+#include <iterator>    // iterator tags.
+#include <stdexcept>   // out of range.
+#include <string>      // encoded keys, string keys.
+#include <type_traits> // enable_if, make_unsigned.
+#include <utility>     // pair.
+#include <vector>      // iteration paths, teardown.
+#include "simd_search.h"
+
+// Order preserving byte encoding of keys.
+template <class T, class Enable = void>
+struct artKey;
+
+// Integers: big-endian, sign bit flipped so negative keys sort first.
+template <class T>
+struct artKey<T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value>::type>
+{
+	static void encode(const T& key, std::string& out)
+	{
+		typedef typename std::make_unsigned<T>::type U;
+		U u = static_cast<U>(key);
+
+		if (std::is_signed<T>::value)
+			u ^= static_cast<U>(U(1) << (sizeof(T) * 8 - 1));
+
+		out.resize(sizeof(T));
+		for (std::size_t i = 0; i < sizeof(T); i++)
+			out[i] = static_cast<char>(u >> (8 * (sizeof(T) - 1 - i)));
+	}
+};
+
+// Strings: 0x00 escaped as 0x00 0xFF, terminated by 0x00 0x00.
+template <>
+struct artKey<std::string>
+{
+	static void encode(const std::string& key, std::string& out)
+	{
+		out.clear();
+		out.reserve(key.size() + 2);
+		for (char c : key)
+		{
+			out += c;
+			if (c == '\0')
+				out += '\xFF';
+		}
+		out += '\0';
+		out += '\0';
+	}
+};
+
+template <class T>
+class artSet
+{
+public:
+	// Compressed path bytes stored in a node.
+	static const std::uint32_t MAX_PREFIX = 8;
+
+private:
+	enum nodeType : std::uint8_t { LEAF, NODE4, NODE16, NODE48, NODE256 };
+
+	struct node
+	{
+		explicit node(nodeType t) : type(t), count(0), prefixLen(0) { }
+
+		nodeType type;
+		std::uint16_t count;     // Children.
+		std::uint32_t prefixLen; // Compressed path length, may exceed MAX_PREFIX.
+		unsigned char prefix[MAX_PREFIX];
+	};
+
+	struct leaf : node
+	{
+		explicit leaf(const T& v) : node(LEAF), value(v) { }
+		T value;
+	};
+
+	struct node4 : node
+	{
+		node4() : node(NODE4) { }
+		unsigned char keys[4];
+		node* children[4] = { };
+	};
+
+	struct node16 : node
+	{
+		node16() : node(NODE16) { }
+		unsigned char keys[16] = { };
+		node* children[16] = { };
+	};
+
+	struct node48 : node
+	{
+		node48() : node(NODE48) { std::memset(index, 0, sizeof(index)); }
+		unsigned char index[256]; // Child slot + 1, 0 when absent.
+		node* children[48] = { };
+	};
+
+	struct node256 : node
+	{
+		node256() : node(NODE256) { }
+		node* children[256] = { };
+	};
+
+public:
+	class iterator;
+	typedef iterator const_iterator;
+
+	artSet() : root(nullptr), count(0) { }
+	artSet(const artSet<T>& rhs) : root(nullptr), count(0)
+	{
+		for (iterator it = rhs.begin(); it != rhs.end(); ++it)
+			insert(*it);
+	}
+	~artSet() { clear(); }
+
+	const artSet<T>& operator= (const artSet<T>& rhs)
+	{
+		if (this != &rhs)
+		{
+			clear();
+			for (iterator it = rhs.begin(); it != rhs.end(); ++it)
+				insert(*it);
+		}
+		return *this;
+	}
+
+	//
+	// Set operations.
+	//
+
+	bool empty() const { return count == 0; }
+	std::size_t size() const { return count; }
+
+	// Delete all nodes, iteratively.
+	void clear()
+	{
+		std::vector<node*> stack;
+
+		if (root)
+			stack.push_back(root);
+		while (stack.size())
+		{
+			node* n = stack.back();
+			stack.pop_back();
+
+			for (int pos = firstFrom(n, 0); pos >= 0; pos = firstFrom(n, pos + 1))
+				stack.push_back(childAt(n, pos));
+			destroy(n);
+		}
+
+		root = nullptr;
+		count = 0;
+	}
+
+	bool add(const T& data) { return insert(data); }
+
+	// Insert data, returns false if already present.
+	bool insert(const T& data)
+	{
+		std::string key;
+		artKey<T>::encode(data, key);
+
+		node** ref = &root;
+		std::size_t depth = 0;
+
+		for (;;)
+		{
+			node* n = *ref;
+
+			if (!n)
+			{
+				*ref = new leaf(data);
+				count++;
+				return true;
+			}
+
+			if (n->type == LEAF)
+			{
+				leaf* l = static_cast<leaf*>(n);
+				if (l->value == data)
+					return false;
+
+				// Split leaf, new node4 holds the path both keys share.
+				std::string other;
+				artKey<T>::encode(l->value, other);
+
+				std::size_t i = depth;
+				while (other[i] == key[i])
+					i++;
+
+				node4* split = new node4();
+				setPrefix(split, key.data() + depth, i - depth);
+				addChild(split, static_cast<unsigned char>(other[i]), l);
+				addChild(split, static_cast<unsigned char>(key[i]), new leaf(data));
+				*ref = split;
+				count++;
+				return true;
+			}
+
+			if (n->prefixLen)
+			{
+				std::string path = fullPrefix(n, depth);
+				std::size_t p = 0;
+				while (p < path.size() && depth + p < key.size() && path[p] == key[depth + p])
+					p++;
+
+				if (p < path.size())
+				{
+					// Key leaves the compressed path, split it at p.
+					node4* split = new node4();
+					setPrefix(split, path.data(), p);
+					setPrefix(n, path.data() + p + 1, path.size() - p - 1);
+					addChild(split, static_cast<unsigned char>(path[p]), n);
+					addChild(split, static_cast<unsigned char>(key[depth + p]), new leaf(data));
+					*ref = split;
+					count++;
+					return true;
+				}
+				depth += path.size();
+			}
+
+			unsigned char b = static_cast<unsigned char>(key[depth]);
+			node** child = findChild(n, b);
+			if (child)
+			{
+				ref = child;
+				depth++;
+				continue;
+			}
+
+			if (full(n))
+				*ref = n = grow(n);
+			addChild(n, b, new leaf(data));
+			count++;
+			return true;
+		}
+	}
+
+	// Returns true if data is present.
+	bool search(const T& data) const
+	{
+		std::string key;
+		artKey<T>::encode(data, key);
+
+		const node* n = root;
+		std::size_t depth = 0;
+
+		while (n)
+		{
+			if (n->type == LEAF)
+				return static_cast<const leaf*>(n)->value == data;
+
+			// Optimistic: only the stored part of the path is compared.
+			if (n->prefixLen)
+			{
+				std::size_t stored = n->prefixLen < MAX_PREFIX ? n->prefixLen : MAX_PREFIX;
+				if (depth + n->prefixLen >= key.size()
+					|| std::memcmp(n->prefix, key.data() + depth, stored) != 0)
+					return false;
+				depth += n->prefixLen;
+			}
+
+			node* const* child = findChild(const_cast<node*>(n), static_cast<unsigned char>(key[depth]));
+			n = child ? *child : nullptr;
+			depth++;
+		}
+
+		return false;
+	}
+
+	// Remove data, returns true if it was present.
+	bool remove(const T& data)
+	{
+		std::string key;
+		artKey<T>::encode(data, key);
+
+		node** parentRef = nullptr;
+		node** ref = &root;
+		unsigned char b = 0;
+		std::size_t depth = 0, parentDepth = 0;
+
+		while (*ref)
+		{
+			node* n = *ref;
+			std::size_t start = depth;
+
+			if (n->type == LEAF)
+			{
+				if (!(static_cast<leaf*>(n)->value == data))
+					return false;
+
+				destroy(n);
+				count--;
+				if (!parentRef)
+					*ref = nullptr;
+				else
+					removeChild(parentRef, b, parentDepth);
+				return true;
+			}
+
+			if (n->prefixLen)
+			{
+				std::size_t stored = n->prefixLen < MAX_PREFIX ? n->prefixLen : MAX_PREFIX;
+				if (depth + n->prefixLen >= key.size()
+					|| std::memcmp(n->prefix, key.data() + depth, stored) != 0)
+					return false;
+				depth += n->prefixLen;
+			}
+
+			b = static_cast<unsigned char>(key[depth]);
+			node** child = findChild(n, b);
+			if (!child)
+				return false;
+
+			parentRef = ref;
+			parentDepth = start;
+			ref = child;
+			depth++;
+		}
+
+		return false;
+	}
+
+	// Smallest key. Throws out_of_range if empty.
+	T lowerBound() const
+	{
+		if (empty())
+			throw std::out_of_range("artSet::lowerBound: empty");
+		return minimum(root)->value;
+	}
+
+	// Largest key. Throws out_of_range if empty.
+	T upperBound() const
+	{
+		if (empty())
+			throw std::out_of_range("artSet::upperBound: empty");
+
+		const node* n = root;
+		while (n->type != LEAF)
+			n = childAt(n, lastPos(n));
+		return static_cast<const leaf*>(n)->value;
+	}
+
+	// Iterator to first key not less than data, end() if none.
+	iterator lowerBound(const T& data) const
+	{
+		std::string key;
+		artKey<T>::encode(data, key);
+
+		iterator it;
+		const node* n = root;
+		std::size_t depth = 0;
+
+		while (n)
+		{
+			if (n->type == LEAF)
+			{
+				it.current = static_cast<const leaf*>(n);
+				if (it.current->value < data)
+					it.next();
+				return it;
+			}
+
+			if (n->prefixLen)
+			{
+				std::string path = fullPrefix(n, depth);
+				int c = path.compare(0, path.size(), key, depth, path.size());
+
+				// Whole subtree sorts after data, or before it.
+				if (c > 0)
+				{
+					it.descend(n);
+					return it;
+				}
+				if (c < 0)
+				{
+					it.next();
+					return it;
+				}
+				depth += path.size();
+			}
+
+			int pos = seekByte(n, static_cast<unsigned char>(key[depth]));
+			if (pos < 0)
+			{
+				it.next();
+				return it;
+			}
+
+			const node* child = childAt(n, pos);
+			it.path.push_back(std::make_pair(n, pos));
+			if (keyByte(n, pos) != static_cast<unsigned char>(key[depth]))
+			{
+				it.descend(child);
+				return it;
+			}
+
+			n = child;
+			depth++;
+		}
+
+		return it;
+	}
+
+	//
+	// Iterators.
+	//
+
+	iterator begin() const
+	{
+		iterator it;
+
+		if (root)
+			it.descend(root);
+		return it;
+	}
+	iterator end() const { return iterator(); }
+	const_iterator cbegin() const { return begin(); }
+	const_iterator cend() const { return end(); }
+
+private:
+	node* root;
+	std::size_t count;
+
+	static void destroy(node* n)
+	{
+		switch (n->type)
+		{
+		case LEAF: delete static_cast<leaf*>(n); break;
+		case NODE4: delete static_cast<node4*>(n); break;
+		case NODE16: delete static_cast<node16*>(n); break;
+		case NODE48: delete static_cast<node48*>(n); break;
+		case NODE256: delete static_cast<node256*>(n); break;
+		}
+	}
+
+	static void setPrefix(node* n, const char* bytes, std::size_t len)
+	{
+		n->prefixLen = static_cast<std::uint32_t>(len);
+		std::memcpy(n->prefix, bytes, len < MAX_PREFIX ? len : MAX_PREFIX);
+	}
+
+	// Whole compressed path of n, n being reached at depth. Paths longer
+	// than the stored part are read from the encoding of any leaf below.
+	static std::string fullPrefix(const node* n, std::size_t depth)
+	{
+		if (n->prefixLen <= MAX_PREFIX)
+			return std::string(reinterpret_cast<const char*>(n->prefix), n->prefixLen);
+
+		std::string key;
+		artKey<T>::encode(minimum(n)->value, key);
+		return key.substr(depth, n->prefixLen);
+	}
+
+	static const leaf* minimum(const node* n)
+	{
+		while (n->type != LEAF)
+			n = childAt(n, firstFrom(n, 0));
+		return static_cast<const leaf*>(n);
+	}
+
+	//
+	// Child access. Positions are slots in node4/node16 and key bytes in
+	// node48/node256, increasing with key order in both.
+	//
+
+	static node** findChild(node* n, unsigned char b)
+	{
+		switch (n->type)
+		{
+		case NODE4:
+		{
+			node4* p = static_cast<node4*>(n);
+			for (int i = 0; i < p->count; i++)
+				if (p->keys[i] == b)
+					return &p->children[i];
+			return nullptr;
+		}
+		case NODE16:
+		{
+			node16* p = static_cast<node16*>(n);
+			int i = simd::findByte16(p->keys, p->count, b);
+			return i >= 0 ? &p->children[i] : nullptr;
+		}
+		case NODE48:
+		{
+			node48* p = static_cast<node48*>(n);
+			return p->index[b] ? &p->children[p->index[b] - 1] : nullptr;
+		}
+		case NODE256:
+		{
+			node256* p = static_cast<node256*>(n);
+			return p->children[b] ? &p->children[b] : nullptr;
+		}
+		default:
+			return nullptr;
+		}
+	}
+
+	static node* childAt(const node* n, int pos)
+	{
+		switch (n->type)
+		{
+		case NODE4: return static_cast<const node4*>(n)->children[pos];
+		case NODE16: return static_cast<const node16*>(n)->children[pos];
+		case NODE48: return static_cast<const node48*>(n)->children[static_cast<const node48*>(n)->index[pos] - 1];
+		case NODE256: return static_cast<const node256*>(n)->children[pos];
+		default: return nullptr;
+		}
+	}
+
+	static unsigned char keyByte(const node* n, int pos)
+	{
+		switch (n->type)
+		{
+		case NODE4: return static_cast<const node4*>(n)->keys[pos];
+		case NODE16: return static_cast<const node16*>(n)->keys[pos];
+		default: return static_cast<unsigned char>(pos);
+		}
+	}
+
+	// First child position not before pos, -1 if none.
+	static int firstFrom(const node* n, int pos)
+	{
+		switch (n->type)
+		{
+		case NODE4:
+		case NODE16:
+			return pos < n->count ? pos : -1;
+		case NODE48:
+			for (; pos < 256; pos++)
+				if (static_cast<const node48*>(n)->index[pos])
+					return pos;
+			return -1;
+		case NODE256:
+			for (; pos < 256; pos++)
+				if (static_cast<const node256*>(n)->children[pos])
+					return pos;
+			return -1;
+		default:
+			return -1;
+		}
+	}
+
+	// Last child position.
+	static int lastPos(const node* n)
+	{
+		int pos = 255;
+
+		switch (n->type)
+		{
+		case NODE4:
+		case NODE16:
+			return n->count - 1;
+		case NODE48:
+			while (!static_cast<const node48*>(n)->index[pos])
+				pos--;
+			return pos;
+		default:
+			while (!static_cast<const node256*>(n)->children[pos])
+				pos--;
+			return pos;
+		}
+	}
+
+	// Position of the first child whose key byte is not less than b, -1
+	// if none.
+	static int seekByte(const node* n, unsigned char b)
+	{
+		switch (n->type)
+		{
+		case NODE4:
+		{
+			const unsigned char* keys = static_cast<const node4*>(n)->keys;
+			for (int i = 0; i < n->count; i++)
+				if (keys[i] >= b)
+					return i;
+			return -1;
+		}
+		case NODE16:
+		{
+			unsigned i = simd::lowerBoundByte16(static_cast<const node16*>(n)->keys, n->count, b);
+			return i < n->count ? static_cast<int>(i) : -1;
+		}
+		default:
+			return firstFrom(n, b);
+		}
+	}
+
+	//
+	// Growing and shrinking.
+	//
+
+	static bool full(const node* n)
+	{
+		switch (n->type)
+		{
+		case NODE4: return n->count == 4;
+		case NODE16: return n->count == 16;
+		case NODE48: return n->count == 48;
+		default: return false;
+		}
+	}
+
+	static void copyHeader(node* to, const node* from)
+	{
+		to->count = from->count;
+		to->prefixLen = from->prefixLen;
+		std::memcpy(to->prefix, from->prefix, MAX_PREFIX);
+	}
+
+	// Replace full node n with the next larger node type.
+	static node* grow(node* n)
+	{
+		node* bigger;
+
+		switch (n->type)
+		{
+		case NODE4:
+		{
+			node4* p = static_cast<node4*>(n);
+			node16* q = new node16();
+			copyHeader(q, p);
+			std::memcpy(q->keys, p->keys, 4);
+			std::memcpy(q->children, p->children, 4 * sizeof(node*));
+			bigger = q;
+			break;
+		}
+		case NODE16:
+		{
+			node16* p = static_cast<node16*>(n);
+			node48* q = new node48();
+			copyHeader(q, p);
+			for (int i = 0; i < 16; i++)
+			{
+				q->children[i] = p->children[i];
+				q->index[p->keys[i]] = static_cast<unsigned char>(i + 1);
+			}
+			bigger = q;
+			break;
+		}
+		default:
+		{
+			node48* p = static_cast<node48*>(n);
+			node256* q = new node256();
+			copyHeader(q, p);
+			for (int b = 0; b < 256; b++)
+				if (p->index[b])
+					q->children[b] = p->children[p->index[b] - 1];
+			bigger = q;
+			break;
+		}
+		}
+
+		destroy(n);
+		return bigger;
+	}
+
+	// Add child under byte b, n has room.
+	static void addChild(node* n, unsigned char b, node* child)
+	{
+		switch (n->type)
+		{
+		case NODE4:
+		case NODE16:
+		{
+			unsigned char* keys;
+			node** children;
+			if (n->type == NODE4)
+			{
+				keys = static_cast<node4*>(n)->keys;
+				children = static_cast<node4*>(n)->children;
+			}
+			else
+			{
+				keys = static_cast<node16*>(n)->keys;
+				children = static_cast<node16*>(n)->children;
+			}
+
+			int i = 0;
+			while (i < n->count && keys[i] < b)
+				i++;
+			std::memmove(keys + i + 1, keys + i, n->count - i);
+			std::memmove(children + i + 1, children + i, (n->count - i) * sizeof(node*));
+			keys[i] = b;
+			children[i] = child;
+			break;
+		}
+		case NODE48:
+		{
+			node48* p = static_cast<node48*>(n);
+			int slot = 0;
+			while (p->children[slot])
+				slot++;
+			p->children[slot] = child;
+			p->index[b] = static_cast<unsigned char>(slot + 1);
+			break;
+		}
+		default:
+			static_cast<node256*>(n)->children[b] = child;
+			break;
+		}
+		n->count++;
+	}
+
+	// Remove child under byte b of *ref, shrinking or collapsing *ref when
+	// it gets sparse. *ref starts at key byte depth.
+	static void removeChild(node** ref, unsigned char b, std::size_t depth)
+	{
+		node* n = *ref;
+
+		switch (n->type)
+		{
+		case NODE4:
+		case NODE16:
+		{
+			unsigned char* keys;
+			node** children;
+			if (n->type == NODE4)
+			{
+				keys = static_cast<node4*>(n)->keys;
+				children = static_cast<node4*>(n)->children;
+			}
+			else
+			{
+				keys = static_cast<node16*>(n)->keys;
+				children = static_cast<node16*>(n)->children;
+			}
+
+			int i = 0;
+			while (keys[i] != b)
+				i++;
+			std::memmove(keys + i, keys + i + 1, n->count - i - 1);
+			std::memmove(children + i, children + i + 1, (n->count - i - 1) * sizeof(node*));
+			children[n->count - 1] = nullptr;
+			break;
+		}
+		case NODE48:
+		{
+			node48* p = static_cast<node48*>(n);
+			p->children[p->index[b] - 1] = nullptr;
+			p->index[b] = 0;
+			break;
+		}
+		default:
+			static_cast<node256*>(n)->children[b] = nullptr;
+			break;
+		}
+		n->count--;
+
+		shrink(ref, depth);
+	}
+
+	// Move *ref to a smaller node type once its children fit with room to
+	// spare, and fold a node4 with one child into that child. *ref starts
+	// at key byte depth.
+	static void shrink(node** ref, std::size_t depth)
+	{
+		node* n = *ref;
+
+		switch (n->type)
+		{
+		case NODE4:
+		{
+			if (n->count != 1)
+				return;
+
+			node4* p = static_cast<node4*>(n);
+			node* child = p->children[0];
+			if (child->type != LEAF)
+			{
+				// Child path becomes this path + key byte + child path.
+				std::size_t len = n->prefixLen + 1 + child->prefixLen;
+				std::string path;
+
+				if (len <= MAX_PREFIX)
+				{
+					path.assign(reinterpret_cast<const char*>(n->prefix), n->prefixLen);
+					path += static_cast<char>(p->keys[0]);
+					path.append(reinterpret_cast<const char*>(child->prefix), child->prefixLen);
+				}
+				else
+				{
+					artKey<T>::encode(minimum(child)->value, path);
+					path = path.substr(depth, len);
+				}
+				setPrefix(child, path.data(), path.size());
+			}
+			*ref = child;
+			destroy(n);
+			return;
+		}
+		case NODE16:
+		{
+			if (n->count > 3)
+				return;
+
+			node16* p = static_cast<node16*>(n);
+			node4* q = new node4();
+			copyHeader(q, p);
+			std::memcpy(q->keys, p->keys, n->count);
+			std::memcpy(q->children, p->children, n->count * sizeof(node*));
+			*ref = q;
+			destroy(n);
+			return;
+		}
+		case NODE48:
+		{
+			if (n->count > 12)
+				return;
+
+			node48* p = static_cast<node48*>(n);
+			node16* q = new node16();
+			copyHeader(q, p);
+			int i = 0;
+			for (int b = 0; b < 256; b++)
+				if (p->index[b])
+				{
+					q->keys[i] = static_cast<unsigned char>(b);
+					q->children[i++] = p->children[p->index[b] - 1];
+				}
+			*ref = q;
+			destroy(n);
+			return;
+		}
+		case NODE256:
+		{
+			if (n->count > 37)
+				return;
+
+			node256* p = static_cast<node256*>(n);
+			node48* q = new node48();
+			copyHeader(q, p);
+			int i = 0;
+			for (int b = 0; b < 256; b++)
+				if (p->children[b])
+				{
+					q->children[i] = p->children[b];
+					q->index[b] = static_cast<unsigned char>(++i);
+				}
+			*ref = q;
+			destroy(n);
+			return;
+		}
+		default:
+			return;
+		}
+	}
+
+};
+
+// Forward iterator, keeps the path of (node, child position) pairs down
+// to the current leaf.
+template <class T>
+class artSet<T>::iterator
+{
+	friend class artSet<T>;
+
+public:
+	typedef std::forward_iterator_tag iterator_category;
+	typedef T value_type;
+	typedef std::ptrdiff_t difference_type;
+	typedef const T* pointer;
+	typedef const T& reference;
+
+	iterator() : current(nullptr) { }
+
+	reference operator*() const { return current->value; }
+	pointer operator->() const { return &current->value; }
+
+	iterator& operator++()
+	{
+		next();
+		return *this;
+	}
+	iterator operator++(int)
+	{
+		iterator old = *this;
+		next();
+		return old;
+	}
+
+	bool operator== (const iterator& rhs) const { return current == rhs.current; }
+	bool operator!= (const iterator& rhs) const { return !(*this == rhs); }
+
+private:
+	// Move to the leftmost leaf below n.
+	void descend(const node* n)
+	{
+		while (n->type != LEAF)
+		{
+			int pos = artSet<T>::firstFrom(n, 0);
+			path.push_back(std::make_pair(n, pos));
+			n = artSet<T>::childAt(n, pos);
+		}
+		current = static_cast<const leaf*>(n);
+	}
+
+	// Move to the leftmost leaf after the current path.
+	void next()
+	{
+		while (path.size())
+		{
+			std::pair<const node*, int>& top = path.back();
+			int pos = artSet<T>::firstFrom(top.first, top.second + 1);
+
+			if (pos >= 0)
+			{
+				top.second = pos;
+				descend(artSet<T>::childAt(top.first, pos));
+				return;
+			}
+			path.pop_back();
+		}
+		current = nullptr;
+	}
+
+	std::vector<std::pair<const node*, int>> path;
+	const leaf* current;
+};
+
+#endif
@@ -0,0 +1,98 @@
+//
+// artSet<int> vs. tree<int> and btree<int>, dense and sparse keys.
+//
+//   art_bench [keys] [btree file]
+//
+// Dense keys are 0..n-1 inserted in random order, sparse keys are random
+// 32-bit values. Every key is then searched once, in a different order.
+// The btree gets a buffer pool large enough to hold the whole set.
+//
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "../art.h"
+#include "../btree.h"
+#include "../tree_with_parent.h"
+
+// Uniform insert/search interface over the three containers.
+struct artCase
+{
+	artSet<int> s;
+	void open(const std::string&, std::size_t) { }
+	void insert(int k) { s.insert(k); }
+	bool search(int k) const { return s.search(k); }
+};
+
+struct treeCase
+{
+	tree<int> t;
+	void open(const std::string&, std::size_t) { }
+	void insert(int k) { t.add(k); }
+	bool search(int k) const { return t.search(k); }
+};
+
+struct btreeCase
+{
+	btree<int> t;
+	void open(const std::string& path, std::size_t n) { t.create(path, n * 2 * sizeof(int) + (1 << 20)); }
+	void insert(int k) { t.insert(k); }
+	bool search(int k) const { return t.search(k); }
+};
+
+template <class Case>
+void run(const char* name, const std::vector<int>& keys, const std::vector<int>& probes, const std::string& path)
+{
+	Case c;
+	c.open(path, keys.size());
+
+	bench::timer clock;
+	for (int k : keys)
+		c.insert(k);
+	bench::report(bench::result{ std::string(name) + " insert", keys.size(), 1, keys.size(), clock.seconds(), clock.counts() });
+
+	std::size_t found = 0;
+	clock.reset();
+	for (int k : probes)
+		found += c.search(k);
+	bench::keep(found);
+	bench::report(bench::result{ std::string(name) + " search", keys.size(), 1, probes.size(), clock.seconds(), clock.counts() });
+}
+
+int main(int argc, char* argv[])
+{
+	std::size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+	std::string path = argc > 2 ? argv[2] : "art_bench.bin";
+	bench::rng r(7);
+
+	std::vector<int> dense(n), sparse(n);
+	for (std::size_t i = 0; i < n; i++)
+	{
+		dense[i] = static_cast<int>(i);
+		sparse[i] = static_cast<int>(r.next());
+	}
+
+	const char* names[] = { "dense", "sparse" };
+	std::vector<int>* sets[] = { &dense, &sparse };
+
+	bench::header();
+	for (int d = 0; d < 2; d++)
+	{
+		std::vector<int>& keys = *sets[d];
+		for (std::size_t i = keys.size(); i > 1; i--)
+			std::swap(keys[i - 1], keys[r.below(i)]);
+
+		std::vector<int> probes(keys);
+		for (std::size_t i = probes.size(); i > 1; i--)
+			std::swap(probes[i - 1], probes[r.below(i)]);
+
+		run<artCase>((std::string("artSet ") + names[d]).c_str(), keys, probes, path);
+		run<treeCase>((std::string("tree<int> ") + names[d]).c_str(), keys, probes, path);
+		run<btreeCase>((std::string("btree ") + names[d]).c_str(), keys, probes, path);
+	}
+
+	std::remove(path.c_str());
+}
@@ -0,0 +1,284 @@
+/*************************************************************************
+* Title: Benchmark Support
+* File: bench.h
+* Date: 10/18/2026
+*
+* Minimal timing and reporting helpers shared by the benchmark programs.
+* Timers also sample the hardware counters of perf_counters.h, reported
+* per operation next to the wall time where the platform provides them.
+*
+* Notes:
+*  (1) Build benchmarks with optimizations enabled. The CMake project
+*      builds them in Release by default, or by hand, for example
+*      g++ -O2 -std=c++17 -pthread -I.. concurrent_set_bench.cpp
+*************************************************************************
+* Change Log:
+*  10/18/2026: Initial release.
+*  10/18/2026: Added zipf generator.
+*  10/18/2026: Added JSON result log.
+*  10/18/2026: Hardware counters per case, normalized per operation.
+*************************************************************************/
+#ifndef _BENCH_H_
+#define _BENCH_H_
+
+#include <algorithm> // upper_bound.
+#include <chrono>    // steady clock.
+#include <cmath>     // pow.
+#include <cstdint>   // fixed width integers.
+#include <cstdio>    // snprintf.
+#include <iomanip>   // setw.
+#include <iostream>  // cout.
+#include <string>    // case names.
+#include <vector>    // zipf cdf, json entries.
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>  // _ReadWriteBarrier.
+#endif
+
+#include "perf_counters.h"
+
+namespace bench
+{
+	// Wall clock stopwatch, also counting hardware events.
+	class timer
+	{
+	public:
+		timer() { reset(); }
+
+		void reset()
+		{
+			startCounts = perfCounters::instance().read();
+			start = std::chrono::steady_clock::now();
+		}
+
+		double seconds() const
+		{
+			return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		}
+
+		// Hardware events since construction or reset.
+		counterSample counts() const { return perfCounters::instance().read() - startCounts; }
+
+	private:
+		std::chrono::steady_clock::time_point start;
+		counterSample startCounts;
+	};
+
+	// Small, fast pseudo random generator (xorshift64*).
+	class rng
+	{
+	public:
+		explicit rng(std::uint64_t seed = 0x2545F4914F6CDD1Dull) : state(seed ? seed : 1) { }
+
+		std::uint64_t next()
+		{
+			state ^= state >> 12;
+			state ^= state << 25;
+			state ^= state >> 27;
+			return state * 0x2545F4914F6CDD1Dull;
+		}
+
+		// Uniform value in [0, n).
+		std::uint64_t below(std::uint64_t n) { return next() % n; }
+
+	private:
+		std::uint64_t state;
+	};
+
+	// Zipf distributed ranks in [0, n), rank 0 the most frequent, with
+	// exponent s. Inverts a precomputed CDF, O(n) memory, O(log n) a draw.
+	class zipf
+	{
+	public:
+		zipf(std::size_t n, double s, std::uint64_t seed = 1) : r(seed), cdf(n ? n : 1)
+		{
+			double sum = 0.0;
+			for (std::size_t i = 0; i < cdf.size(); i++)
+				cdf[i] = sum += 1.0 / std::pow(static_cast<double>(i + 1), s);
+			for (double& c : cdf)
+				c /= sum;
+		}
+
+		std::size_t next()
+		{
+			double u = (r.next() >> 11) * (1.0 / 9007199254740992.0);
+			std::size_t i = std::upper_bound(cdf.begin(), cdf.end(), u) - cdf.begin();
+			return i < cdf.size() ? i : cdf.size() - 1;
+		}
+
+	private:
+		rng r;
+		std::vector<double> cdf;
+	};
+
+	// One measured case.
+	struct result
+	{
+		std::string name;     // Container/operation.
+		std::size_t n;        // Data set size.
+		std::size_t threads;  // Worker threads.
+		std::size_t ops;      // Operations performed.
+		double seconds;       // Elapsed wall time.
+		counterSample counts; // Hardware events, timer::counts().
+	};
+
+	// Opens the hardware counters, before any worker thread starts, and
+	// prints the table header, with counter columns if any opened.
+	inline void header()
+	{
+		const perfCounters& pc = perfCounters::instance();
+
+		if (!pc.available())
+			std::cout << "# hardware counters unavailable (" << pc.error() << "), wall time only\n";
+
+		std::cout << std::left << std::setw(40) << "case" << std::right
+			<< std::setw(12) << "n" << std::setw(9) << "threads"
+			<< std::setw(14) << "Mops/s" << std::setw(12) << "ns/op";
+		if (pc.available())
+			for (int i = 0; i < COUNTER_COUNT; i++)
+				std::cout << std::setw(17) << std::string(counterName(static_cast<counterId>(i))) + "/op";
+		std::cout << "\n";
+	}
+
+	inline void report(const result& r)
+	{
+		double nsPerOp = r.ops ? r.seconds * 1e9 / r.ops : 0.0;
+		double mops = r.seconds > 0 ? r.ops / r.seconds / 1e6 : 0.0;
+
+		std::cout << std::left << std::setw(40) << r.name << std::right
+			<< std::setw(12) << r.n << std::setw(9) << r.threads
+			<< std::setw(14) << std::fixed << std::setprecision(3) << mops
+			<< std::setw(12) << std::setprecision(1) << nsPerOp;
+
+		// Missing counters print as "-", a case that took no counts as blanks.
+		if (perfCounters::instance().available())
+			for (int i = 0; i < COUNTER_COUNT; i++)
+			{
+				if (r.counts.valid[i] && r.ops)
+					std::cout << std::setw(17) << std::setprecision(2) << r.counts.value[i] / r.ops;
+				else
+					std::cout << std::setw(17) << (r.counts.any() ? "-" : "");
+			}
+		std::cout << "\n";
+	}
+
+	// s quoted and escaped as a JSON string.
+	inline std::string jsonString(const std::string& s)
+	{
+		std::string out = "\"";
+
+		for (char c : s)
+		{
+			if (c == '"' || c == '\\')
+				out += '\\';
+			if (static_cast<unsigned char>(c) < 0x20)
+			{
+				char buf[8];
+				std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned>(static_cast<unsigned char>(c)));
+				out += buf;
+			}
+			else
+				out += c;
+		}
+		return out + "\"";
+	}
+
+	inline std::string compilerName()
+	{
+#if defined(__clang__)
+		return "clang " __clang_version__;
+#elif defined(__GNUC__)
+		return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+		return "msvc " + std::to_string(_MSC_VER);
+#else
+		return "unknown";
+#endif
+	}
+
+	// Results collected into a machine readable JSON document, one object
+	// per case labelled by container, workload and operation, so runs of
+	// different versions can be matched case by case:
+	//
+	//   { "suite": ..., "version": ..., "compiler": ...,
+	//     "results": [ { "container": ..., "workload": ..., "op": ...,
+	//                    "n": ..., "threads": ..., "ops": ...,
+	//                    "seconds": ..., "ns_per_op": ...,
+	//                    "per_op": { "cycles": ..., ... } }, ... ] }
+	//
+	// per_op holds the hardware counters divided by ops, null where a
+	// counter is missing, and is left out when none were sampled.
+	class jsonLog
+	{
+	public:
+		void add(const result& r, const std::string& container, const std::string& workload, const std::string& op)
+		{
+			entries.push_back(entry{ r, container, workload, op });
+		}
+
+		bool empty() const { return entries.empty(); }
+
+		void write(std::ostream& os, const std::string& suite, const std::string& version) const
+		{
+			os << "{\n  \"suite\": " << jsonString(suite)
+				<< ",\n  \"version\": " << jsonString(version)
+				<< ",\n  \"compiler\": " << jsonString(compilerName())
+				<< ",\n  \"results\": [";
+
+			for (std::size_t i = 0; i < entries.size(); i++)
+			{
+				const entry& e = entries[i];
+				os << (i ? ",\n" : "\n") << "    { \"container\": " << jsonString(e.container)
+					<< ", \"workload\": " << jsonString(e.workload)
+					<< ", \"op\": " << jsonString(e.op)
+					<< ", \"n\": " << e.r.n
+					<< ", \"threads\": " << e.r.threads
+					<< ", \"ops\": " << e.r.ops
+					<< ", \"seconds\": " << std::setprecision(9) << e.r.seconds
+					<< ", \"ns_per_op\": " << std::setprecision(6) << (e.r.ops ? e.r.seconds * 1e9 / e.r.ops : 0.0);
+
+				if (e.r.counts.any())
+				{
+					os << ", \"per_op\": {";
+					for (int c = 0; c < COUNTER_COUNT; c++)
+					{
+						os << (c ? ", \"" : " \"") << counterName(static_cast<counterId>(c)) << "\": ";
+						if (e.r.counts.valid[c] && e.r.ops)
+							os << e.r.counts.value[c] / e.r.ops;
+						else
+							os << "null";
+					}
+					os << " }";
+				}
+				os << " }";
+			}
+			os << "\n  ]\n}\n";
+		}
+
+	private:
+		struct entry
+		{
+			result r;
+			std::string container;
+			std::string workload;
+			std::string op;
+		};
+		std::vector<entry> entries;
+	};
+
+	// Defeat dead code elimination of benchmark results. The value is
+	// only made to look used, nothing is shared between threads.
+	template <class T>
+	inline void keep(const T& value)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "g"(&value) : "memory");
+#else
+		static thread_local const void* volatile sink;
+		sink = &value;
+		_ReadWriteBarrier();
+#endif
+	}
+}
+
+#endif
@@ -0,0 +1,54 @@
+//
+// tree<T>::search with and without the Bloom filter on a miss heavy load.
+//
+//   bloom_bench [max keys] [miss percent] [false positive rate]
+//
+// Each size builds a balanced tree from random even keys, then searches
+// random keys of which the given share (default 90%) are odd, so absent.
+//
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "../tree_with_parent.h"
+
+int main(int argc, char* argv[])
+{
+	std::size_t maxKeys = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4000000;
+	std::size_t missPercent = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 90;
+	double rate = argc > 3 ? std::atof(argv[3]) : 0.01;
+	const std::size_t probes = 2000000;
+	bench::rng r(13);
+
+	bench::header();
+	for (std::size_t n = 10000; n <= maxKeys; n *= 4)
+	{
+		std::vector<int> keys(n);
+		for (std::size_t i = 0; i < n; i++)
+			keys[i] = static_cast<int>(r.next() >> 33) * 2;
+
+		tree<int> t;
+		t.insert_batch(keys.begin(), keys.end());
+
+		std::vector<int> lookups(probes);
+		for (std::size_t i = 0; i < probes; i++)
+			lookups[i] = keys[r.below(n)] + (r.below(100) < missPercent ? 1 : 0);
+
+		std::size_t hits = 0;
+		bench::timer clock;
+		for (std::size_t i = 0; i < probes; i++)
+			hits += t.search(lookups[i]);
+		bench::report(bench::result{ "tree search", n, 1, probes, clock.seconds(), clock.counts() });
+
+		t.enableFilter(rate);
+		clock.reset();
+		for (std::size_t i = 0; i < probes; i++)
+			hits += t.search(lookups[i]);
+		bench::report(bench::result{ "tree search, filter " + std::to_string(t.filterBytes() >> 10) + " KiB", n, 1, probes, clock.seconds(), clock.counts() });
+
+		bench::keep(hits);
+	}
+
+	return 0;
+}
@@ -0,0 +1,71 @@
+//
+// Paged btree<T> throughput as the data set grows past the buffer pool.
+//
+//   btree_bench [max keys] [pool budget MiB] [file]
+//
+// Each size builds a fresh file from random keys, then runs random
+// searches and a full sequential scan. Case names carry the pool hit rate.
+//
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+#include "bench.h"
+#include "../btree.h"
+
+// Pool hit rate since the previous call, as a case name suffix.
+static std::string hitRate(const btree<std::uint64_t>& t, bufferPool::counters& last)
+{
+	bufferPool::counters now = t.poolStats();
+	std::uint64_t hits = now.hits - last.hits, misses = now.misses - last.misses;
+	std::ostringstream s;
+
+	s.precision(1);
+	s << std::fixed << " (hit " << (hits + misses ? 100.0 * hits / (hits + misses) : 100.0) << "%)";
+	last = now;
+	return s.str();
+}
+
+int main(int argc, char* argv[])
+{
+	std::size_t maxKeys = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000000;
+	std::size_t budget = (argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 16) << 20;
+	std::string path = argc > 3 ? argv[3] : "btree_bench.bin";
+
+	std::cout << "buffer pool " << (budget >> 20) << " MiB, "
+		<< budget / bufferPool::PAGE_SIZE << " pages\n";
+	bench::header();
+
+	for (std::size_t n = 10000; n <= maxKeys; n *= 10)
+	{
+		btree<std::uint64_t> t;
+		bufferPool::counters last = bufferPool::counters();
+		bench::rng r(n);
+		bench::timer clock;
+
+		t.create(path, budget);
+		for (std::size_t i = 0; i < n; i++)
+			t.insert(r.next());
+		t.flush();
+		bench::report(bench::result{ "btree insert" + hitRate(t, last), n, 1, n, clock.seconds(), clock.counts() });
+
+		// Half the probes hit, replaying the insert sequence.
+		std::size_t probes = n < 1000000 ? n : 1000000, found = 0;
+		bench::rng hit(n), miss(~n);
+		clock.reset();
+		for (std::size_t i = 0; i < probes; i++)
+			found += t.search(i & 1 ? miss.next() : hit.next());
+		bench::keep(found);
+		bench::report(bench::result{ "btree search" + hitRate(t, last), n, 1, probes, clock.seconds(), clock.counts() });
+
+		std::uint64_t sum = 0;
+		clock.reset();
+		for (btree<std::uint64_t>::iterator it = t.begin(); it != t.end(); ++it)
+			sum += *it;
+		bench::keep(sum);
+		bench::report(bench::result{ "btree scan" + hitRate(t, last), n, 1, t.size(), clock.seconds(), clock.counts() });
+	}
+
+	std::remove(path.c_str());
+}
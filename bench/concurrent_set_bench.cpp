@@ -0,0 +1,96 @@
+//
+// concurrentSet vs. mutex wrapped tree<T> throughput, 1 to 64 threads.
+//
+//   concurrent_set_bench [keys] [ops per thread] [search percent]
+//
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "bench.h"
+#include "../concurrent_set.h"
+#include "../tree_with_parent.h"
+
+// Serialize every operation of a tree<T> through one mutex.
+template <class T>
+class lockedTree
+{
+public:
+	bool add(const T& data)
+	{
+		std::lock_guard<std::mutex> lock(m);
+		if (t.search(data))
+			return false;
+		t.add(data);
+		return true;
+	}
+	bool remove(const T& data)
+	{
+		std::lock_guard<std::mutex> lock(m);
+		return t.remove(data);
+	}
+	bool search(const T& data)
+	{
+		std::lock_guard<std::mutex> lock(m);
+		return t.search(data);
+	}
+
+private:
+	std::mutex m;
+	tree<T> t;
+};
+
+template <class Set>
+bench::result run(const char* name, std::size_t keys, std::size_t threads, std::size_t opsPerThread, unsigned searchPct)
+{
+	Set s;
+	bench::rng fill(42);
+
+	// Pre-populate half the key space, in random order to avoid degenerate trees.
+	for (std::size_t i = 0; i < keys / 2; i++)
+		s.add(static_cast<int>(fill.below(keys)));
+
+	std::vector<std::thread> workers;
+	bench::timer t;
+
+	for (std::size_t w = 0; w < threads; w++)
+		workers.emplace_back([&s, w, keys, opsPerThread, searchPct]
+		{
+			bench::rng r(w + 1);
+			std::size_t hits = 0;
+
+			for (std::size_t i = 0; i < opsPerThread; i++)
+			{
+				int key = static_cast<int>(r.below(keys));
+				unsigned op = static_cast<unsigned>(r.below(100));
+
+				if (op < searchPct)
+					hits += s.search(key);
+				else if ((op - searchPct) & 1)
+					hits += s.add(key);
+				else
+					hits += s.remove(key);
+			}
+			bench::keep(hits);
+		});
+
+	for (auto& w : workers)
+		w.join();
+
+	return bench::result{ name, keys, threads, threads * opsPerThread, t.seconds(), t.counts() };
+}
+
+int main(int argc, char* argv[])
+{
+	std::size_t keys = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1 << 16;
+	std::size_t ops = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100000;
+	unsigned searchPct = argc > 3 ? static_cast<unsigned>(std::atoi(argv[3])) : 90;
+
+	bench::header();
+	for (std::size_t threads = 1; threads <= 64; threads *= 2)
+	{
+		bench::report(run<concurrentSet<int>>("concurrentSet", keys, threads, ops, searchPct));
+		bench::report(run<lockedTree<int>>("mutex tree<T>", keys, threads, ops, searchPct));
+	}
+}
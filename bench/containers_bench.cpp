@@ -0,0 +1,432 @@
+//
+// Every container of the repo against its standard library counterpart:
+//
+//   Tree, tree    vs. std::multiset (all three keep duplicates)
+//   set           vs. std::set
+//   Stack         vs. std::stack
+//   Queue         vs. std::deque
+//   Vector        vs. std::vector
+//   myList::list  vs. std::forward_list
+//
+//   containers_bench [--min=N] [--max=N] [--workloads=LIST] [--containers=LIST]
+//                    [--degenerate-max=N] [--json=FILE] [--version=S]
+//
+// Workloads give the key sequence: sorted, random (a permutation), reverse
+// and zipf (exponent 0.99 over a random permutation, so with duplicates).
+// Sizes grow x10 from --min (default 1e3) to --max (default 1e6, the suite
+// is meant to run up to 1e8). Trees insert then search the sequence and
+// iterate, stacks push then pop, queues stream it through a 1024 element
+// window, vectors push_back then read at the sequence's indexes, lists
+// append, iterate and find.
+//
+// Tree and tree are not self balancing: sorted and reverse input turn them
+// into lists, as do the long runs of duplicates of zipf, and set on sorted
+// and reverse input. Those cases cost O(n^2) and are skipped above
+// --degenerate-max keys (default 20000).
+//
+// --json writes every case to FILE as JSON (see bench::jsonLog), labelled
+// with --version (default: the CMake configured git revision).
+//
+#include <algorithm>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <forward_list>
+#include <set>
+#include <stack>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "../queue.h"
+#include "../set.h"
+#include "../slist.h"
+#include "../stack.h"
+#include "../tree.h"
+#include "../tree_with_parent.h"
+#include "../vector.h"
+
+#ifndef BENCH_VERSION
+#define BENCH_VERSION "unknown"
+#endif
+
+struct options
+{
+	std::size_t min = 1000;
+	std::size_t max = 1000000;
+	std::size_t degenerateMax = 20000;
+	std::string workloads = "sorted,random,reverse,zipf";
+	std::string containers = "Tree,tree,set,Stack,Queue,Vector,list";
+	std::string json;
+	std::string version = BENCH_VERSION;
+};
+
+// True if name is an item of the comma separated list.
+static bool listed(const std::string& list, const std::string& name)
+{
+	return ("," + list + ",").find("," + name + ",") != std::string::npos;
+}
+
+// Key sequence of workload w, values in [0, n).
+static std::vector<int> workload(const std::string& w, std::size_t n, bench::rng& r)
+{
+	std::vector<int> keys(n);
+	for (std::size_t i = 0; i < n; i++)
+		keys[i] = static_cast<int>(i);
+
+	if (w == "reverse")
+		std::reverse(keys.begin(), keys.end());
+	else if (w == "random" || w == "zipf")
+	{
+		for (std::size_t i = n; i > 1; i--)
+			std::swap(keys[i - 1], keys[r.below(i)]);
+
+		if (w == "zipf")
+		{
+			// Ranks over at most 1M keys, keeping the cdf small at 1e8.
+			std::size_t universe = n < 1000000 ? n : 1000000;
+			bench::zipf z(universe, 0.99, r.next());
+			std::vector<int> ranked(keys.begin(), keys.begin() + universe);
+			for (std::size_t i = 0; i < n; i++)
+				keys[i] = ranked[z.next()];
+		}
+	}
+	return keys;
+}
+
+// Times cases and logs them to the table and the JSON log.
+class recorder
+{
+public:
+	recorder(bench::jsonLog& log, const std::string& workload, std::size_t n) : log(log), workload(workload), n(n) { }
+
+	void start() { clock.reset(); }
+
+	void stop(const std::string& container, const std::string& op, std::size_t ops)
+	{
+		bench::result r{ container + " " + workload + " " + op, n, 1, ops, clock.seconds(), clock.counts() };
+		bench::report(r);
+		log.add(r, container, workload, op);
+	}
+
+private:
+	bench::jsonLog& log;
+	std::string workload;
+	std::size_t n;
+	bench::timer clock;
+};
+
+//
+// Ordered containers: insert, search, iterate.
+//
+
+struct TreeCase
+{
+	Tree<int> c;
+	void insert(int k) { c.add(k); }
+	bool search(int k) const { return c.search(k); }
+	long long sum() const { return 0; } // No iterators, traversals print.
+	static bool iterable() { return false; }
+};
+
+template <class Container>
+struct treeCase
+{
+	Container c;
+	void insert(int k) { c.add(k); }
+	bool search(int k) const { return c.search(k); }
+	long long sum() const
+	{
+		long long s = 0;
+		for (auto it = c.begin(), e = c.end(); it != e; ++it)
+			s += *it;
+		return s;
+	}
+	static bool iterable() { return true; }
+};
+
+struct setCase : treeCase<set<int>>
+{
+	void insert(int k) { c.insert(k); }
+};
+
+template <class Container>
+struct stdSetCase
+{
+	Container c;
+	void insert(int k) { c.insert(k); }
+	bool search(int k) const { return c.find(k) != c.end(); }
+	long long sum() const
+	{
+		long long s = 0;
+		for (int k : c)
+			s += k;
+		return s;
+	}
+	static bool iterable() { return true; }
+};
+
+template <class Case>
+void ordered(const char* name, const std::vector<int>& keys, recorder& rec)
+{
+	Case c;
+	std::size_t found = 0;
+
+	rec.start();
+	for (int k : keys)
+		c.insert(k);
+	rec.stop(name, "insert", keys.size());
+
+	rec.start();
+	for (int k : keys)
+		found += c.search(k);
+	rec.stop(name, "search", keys.size());
+	bench::keep(found);
+
+	if (Case::iterable())
+	{
+		rec.start();
+		bench::keep(c.sum());
+		rec.stop(name, "iterate", keys.size());
+	}
+}
+
+//
+// Sequence containers.
+//
+
+static void stacks(const std::vector<int>& keys, recorder& rec)
+{
+	long long sum = 0;
+	{
+		Stack<int> s;
+		rec.start();
+		for (int k : keys)
+			s.push(k);
+		rec.stop("Stack", "push", keys.size());
+
+		rec.start();
+		while (!s.empty())
+			sum += s.pop();
+		rec.stop("Stack", "pop", keys.size());
+	}
+	{
+		std::stack<int> s;
+		rec.start();
+		for (int k : keys)
+			s.push(k);
+		rec.stop("std::stack", "push", keys.size());
+
+		rec.start();
+		while (!s.empty())
+		{
+			sum += s.top();
+			s.pop();
+		}
+		rec.stop("std::stack", "pop", keys.size());
+	}
+	bench::keep(sum);
+}
+
+// Queue size is a compile time constant, keys stream through a window.
+const std::size_t QUEUE_WINDOW = 1024;
+
+static void queues(const std::vector<int>& keys, recorder& rec)
+{
+	long long sum = 0;
+	{
+		Queue<int, QUEUE_WINDOW + 1> q;
+		rec.start();
+		for (std::size_t i = 0; i < keys.size(); i++)
+		{
+			if (q.isFull())
+			{
+				sum += q.front();
+				q.dequeue();
+			}
+			q.enqueue(keys[i]);
+		}
+		while (!q.empty())
+		{
+			sum += q.front();
+			q.dequeue();
+		}
+		rec.stop("Queue", "enqueue+dequeue", keys.size());
+	}
+	{
+		std::deque<int> q;
+		rec.start();
+		for (std::size_t i = 0; i < keys.size(); i++)
+		{
+			if (q.size() == QUEUE_WINDOW + 1)
+			{
+				sum += q.front();
+				q.pop_front();
+			}
+			q.push_back(keys[i]);
+		}
+		while (!q.empty())
+		{
+			sum += q.front();
+			q.pop_front();
+		}
+		rec.stop("std::deque", "enqueue+dequeue", keys.size());
+	}
+	bench::keep(sum);
+}
+
+template <class V>
+void vectorCase(const char* name, const std::vector<int>& keys, recorder& rec)
+{
+	V v;
+	long long sum = 0;
+
+	rec.start();
+	for (int k : keys)
+		v.push_back(k);
+	rec.stop(name, "push_back", keys.size());
+
+	// Keys are indexes in [0, n), read in workload order.
+	rec.start();
+	for (int k : keys)
+		sum += v[static_cast<std::size_t>(k)];
+	rec.stop(name, "index", keys.size());
+	bench::keep(sum);
+}
+
+// Linear finds, limited to about 1e8 node visits.
+static std::size_t findProbes(std::size_t n)
+{
+	std::size_t p = 100000000 / (n ? n : 1);
+	return p < 1 ? 1 : p > 1000 ? 1000 : p;
+}
+
+static void lists(const std::vector<int>& keys, recorder& rec)
+{
+	std::size_t probes = findProbes(keys.size()), found = 0;
+	long long sum = 0;
+	{
+		myList::list<int> l;
+		rec.start();
+		for (int k : keys)
+			l.add(k);
+		rec.stop("myList::list", "append", keys.size());
+
+		rec.start();
+		for (auto it = l.begin(), e = l.end(); it != e; ++it)
+			sum += *it;
+		rec.stop("myList::list", "iterate", keys.size());
+
+		rec.start();
+		for (std::size_t i = 0; i < probes; i++)
+			found += l.find(keys[i * keys.size() / probes]) != nullptr;
+		rec.stop("myList::list", "find", probes);
+	}
+	{
+		std::forward_list<int> l;
+		rec.start();
+		auto tail = l.before_begin();
+		for (int k : keys)
+			tail = l.insert_after(tail, k);
+		rec.stop("std::forward_list", "append", keys.size());
+
+		rec.start();
+		for (int k : l)
+			sum += k;
+		rec.stop("std::forward_list", "iterate", keys.size());
+
+		rec.start();
+		for (std::size_t i = 0; i < probes; i++)
+			found += std::find(l.begin(), l.end(), keys[i * keys.size() / probes]) != l.end();
+		rec.stop("std::forward_list", "find", probes);
+	}
+	bench::keep(sum + static_cast<long long>(found));
+}
+
+int main(int argc, char* argv[])
+{
+	options o;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		std::size_t eq = arg.find('=');
+		std::string key = arg.substr(0, eq), value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+
+		if (key == "--min")
+			o.min = static_cast<std::size_t>(std::atof(value.c_str()));
+		else if (key == "--max")
+			o.max = static_cast<std::size_t>(std::atof(value.c_str()));
+		else if (key == "--degenerate-max")
+			o.degenerateMax = static_cast<std::size_t>(std::atof(value.c_str()));
+		else if (key == "--workloads")
+			o.workloads = value;
+		else if (key == "--containers")
+			o.containers = value;
+		else if (key == "--json")
+			o.json = value;
+		else if (key == "--version")
+			o.version = value;
+		else
+		{
+			std::cerr << "usage: containers_bench [--min=N] [--max=N] [--workloads=LIST] [--containers=LIST]"
+				" [--degenerate-max=N] [--json=FILE] [--version=S]\n";
+			return 2;
+		}
+	}
+
+	bench::jsonLog log;
+	bench::rng r(23);
+	const char* workloads[] = { "sorted", "random", "reverse", "zipf" };
+
+	bench::header();
+	for (std::size_t n = o.min ? o.min : 1; n <= o.max; n *= 10)
+		for (const char* w : workloads)
+		{
+			if (!listed(o.workloads, w))
+				continue;
+
+			std::vector<int> keys = workload(w, n, r);
+			recorder rec(log, w, n);
+			std::string wl = w;
+			bool monotonic = wl == "sorted" || wl == "reverse";
+			bool small = n <= o.degenerateMax;
+
+			if (listed(o.containers, "Tree") && (small || wl == "random"))
+				ordered<TreeCase>("Tree", keys, rec);
+			if (listed(o.containers, "tree") && (small || wl == "random"))
+				ordered<treeCase<tree<int>>>("tree", keys, rec);
+			if (listed(o.containers, "Tree") || listed(o.containers, "tree"))
+				ordered<stdSetCase<std::multiset<int>>>("std::multiset", keys, rec);
+			if (listed(o.containers, "set"))
+			{
+				if (small || !monotonic)
+					ordered<setCase>("set", keys, rec);
+				ordered<stdSetCase<std::set<int>>>("std::set", keys, rec);
+			}
+			if (listed(o.containers, "Stack"))
+				stacks(keys, rec);
+			if (listed(o.containers, "Queue"))
+				queues(keys, rec);
+			if (listed(o.containers, "Vector"))
+			{
+				vectorCase<Vector<int>>("Vector", keys, rec);
+				vectorCase<std::vector<int>>("std::vector", keys, rec);
+			}
+			if (listed(o.containers, "list"))
+				lists(keys, rec);
+		}
+
+	if (!o.json.empty())
+	{
+		std::ofstream os(o.json);
+		log.write(os, "containers_bench", o.version);
+		if (!os)
+		{
+			std::cerr << "containers_bench: cannot write " << o.json << "\n";
+			return 1;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,66 @@
+//
+// tree<T>::search with and without the hot key cache on Zipfian reads.
+//
+//   hot_cache_bench [keys] [cache slots]
+//
+// Builds a balanced tree of random keys, then searches keys drawn with
+// Zipf exponents from 0 (uniform) to 1.5, ranks mapped to random keys.
+// Case names carry the cache hit rate.
+//
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "../tree_with_parent.h"
+
+int main(int argc, char* argv[])
+{
+	std::size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+	std::size_t slots = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 4096;
+	const std::size_t probes = 4000000;
+	bench::rng r(17);
+
+	std::vector<int> keys(n ? n : 1);
+	for (int& k : keys)
+		k = static_cast<int>(r.next() >> 33);
+
+	tree<int> t;
+	t.insert_batch(keys.begin(), keys.end());
+
+	bench::header();
+	for (double s : { 0.0, 0.5, 0.8, 0.99, 1.2, 1.5 })
+	{
+		bench::zipf z(keys.size(), s, 19);
+		std::vector<int> lookups(probes);
+		for (int& k : lookups)
+			k = keys[z.next()];
+
+		char exponent[32];
+		std::snprintf(exponent, sizeof(exponent), "zipf %.2f", s);
+
+		std::size_t hits = 0;
+		bench::timer clock;
+		for (int k : lookups)
+			hits += t.search(k);
+		bench::report(bench::result{ std::string("tree search, ") + exponent, n, 1, probes, clock.seconds(), clock.counts() });
+
+		t.enableCache(slots);
+		clock.reset();
+		for (int k : lookups)
+			hits += t.search(k);
+		double seconds = clock.seconds();
+		bench::counterSample counts = clock.counts();
+		tree<int>::cacheCounters c = t.cacheStats();
+		t.disableCache();
+
+		char rate[32];
+		std::snprintf(rate, sizeof(rate), " (hit %.1f%%)", 100.0 * c.hits / (c.hits + c.misses));
+		bench::report(bench::result{ std::string("cached, ") + exponent + rate, n, 1, probes, seconds, counts });
+
+		bench::keep(hits);
+	}
+
+	return 0;
+}
@@ -0,0 +1,108 @@
+//
+// Per operation latency percentiles of tree<T, latencyStats>, on random
+// and on sorted keys.
+//
+//   latency_bench [keys] [json file]
+//
+// Each workload adds the keys, searches each once, iterates, removes a
+// tenth of them and balances, then prints percentiles per operation.
+// Sorted keys go through the insert finger and stay cheap to add, but
+// leave a list for search and remove until balance. The incremental
+// workload balances the sorted list with rebalance_start instead, in
+// slices carried by a second round of searches, with no single O(n)
+// balance. The JSON file gets every workload's histograms,
+// latencySnapshot::write format.
+//
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "../latency.h"
+#include "../tree_with_parent.h"
+
+static latencySnapshot run(const std::vector<int>& keys, bool incremental = false)
+{
+	tree<int, latencyStats> t;
+	std::size_t hits = 0;
+
+	for (int k : keys)
+		t.add(k);
+	for (int k : keys)
+		hits += t.search(k);
+	for (auto it = t.begin(); it != t.end(); ++it)
+		hits += *it & 1;
+	for (std::size_t i = 0; i < keys.size(); i += 10)
+		hits += t.remove(keys[i]);
+
+	if (!incremental)
+		t.balance();
+	else
+	{
+		t.rebalance_start(32);
+		for (std::size_t i = 0; t.rebalancing(); i++)
+			hits += t.search(keys[i % keys.size()]);
+	}
+
+	bench::keep(hits);
+	return t.policy().snapshot();
+}
+
+static void print(const std::string& workload, const latencySnapshot& s)
+{
+	std::cout << std::left << std::setw(16) << workload << std::setw(10) << "op" << std::right
+		<< std::setw(10) << "count" << std::setw(12) << "p50 ns" << std::setw(12) << "p90 ns"
+		<< std::setw(12) << "p99 ns" << std::setw(12) << "p99.9 ns" << std::setw(14) << "max ns" << "\n";
+
+	for (int i = 0; i < OP_COUNT; i++)
+	{
+		treeOp op = static_cast<treeOp>(i);
+		if (!s[op].count())
+			continue;
+
+		std::cout << std::left << std::setw(16) << "" << std::setw(10) << opName(op) << std::right
+			<< std::setw(10) << s[op].count() << std::fixed << std::setprecision(0)
+			<< std::setw(12) << s.percentileNs(op, 50) << std::setw(12) << s.percentileNs(op, 90)
+			<< std::setw(12) << s.percentileNs(op, 99) << std::setw(12) << s.percentileNs(op, 99.9)
+			<< std::setw(14) << s[op].max() * latencyClock::nsPerTick() << "\n";
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	std::size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000;
+	bench::rng r(17);
+
+	std::vector<int> sorted(n), random(n);
+	for (std::size_t i = 0; i < n; i++)
+		sorted[i] = random[i] = static_cast<int>(i);
+	for (std::size_t i = n; i > 1; i--)
+		std::swap(random[i - 1], random[r.below(i)]);
+
+	latencySnapshot a = run(random), b = run(sorted), c = run(sorted, true);
+	print("random", a);
+	print("sorted", b);
+	print("incremental", c);
+
+	if (argc > 2)
+	{
+		std::ofstream os(argv[2]);
+		os << "{\n\"random\": ";
+		a.write(os);
+		os << ",\n\"sorted\": ";
+		b.write(os);
+		os << ",\n\"incremental\": ";
+		c.write(os);
+		os << "}\n";
+		if (!os)
+		{
+			std::cerr << "latency_bench: cannot write " << argv[2] << "\n";
+			return 1;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,198 @@
+/*************************************************************************
+* Title: Hardware Performance Counters
+* File: perf_counters.h
+* Date: 10/18/2026
+*
+* Process wide hardware event counters for the benchmark programs, read
+* through Linux perf_event_open:
+*
+*   perfCounters::instance() // counters of this process, opened once.
+*   available()              // true if any counter could be opened.
+*   available(id)            // true if counter id could be opened.
+*   error()                  // why counters are missing, if they are.
+*   read()                   // cumulative counts, a counterSample.
+*
+*   counterSample b - a      // events between two reads.
+*
+* Counters: cycles, instructions, L1 data cache read misses, last level
+* cache misses, data TLB read misses and branch misses.
+*
+* Notes:
+*  (1) Counters run from the first instance() call, user space only, and
+*      are inherited by threads created afterwards. bench::header() opens
+*      them, so call it before starting worker threads. Counts of worker
+*      threads are added once the threads exit.
+*  (2) Each event is opened on its own, a PMU lacking one event (dTLB on
+*      many virtual machines) keeps the others. When the PMU has fewer
+*      registers than events the kernel multiplexes them, counts are then
+*      scaled by enabled/running time and are estimates.
+*  (3) Everything is unavailable, never an error, off Linux, inside
+*      containers without a PMU, when perf_event_paranoid forbids it, or
+*      with BENCH_COUNTERS=0 in the environment. Benchmarks then report
+*      wall time only.
+*************************************************************************
+* Change Log:
+*  10/18/2026: Initial release.
+*************************************************************************/
+#ifndef _PERF_COUNTERS_H_
+#define _PERF_COUNTERS_H_
+
+#include <cstdint>  // counts.
+#include <cstdlib>  // getenv.
+#include <cstring>  // strerror, memset.
+#include <string>   // error text.
+
+#if defined(__linux__)
+#include <cerrno>              // errno.
+#include <linux/perf_event.h>  // perf_event_attr.
+#include <sys/ioctl.h>         // enable.
+#include <sys/syscall.h>       // perf_event_open.
+#include <unistd.h>            // read, close.
+#endif
+
+namespace bench
+{
+	enum counterId { CYCLES, INSTRUCTIONS, L1D_MISSES, LLC_MISSES, DTLB_MISSES, BRANCH_MISSES, COUNTER_COUNT };
+
+	// Short names, used as table columns and JSON keys.
+	inline const char* counterName(counterId id)
+	{
+		static const char* names[COUNTER_COUNT] = { "cycles", "instructions", "l1d_misses", "llc_misses", "dtlb_misses", "branch_misses" };
+		return id < COUNTER_COUNT ? names[id] : "unknown";
+	}
+
+	// Counts of all counters, valid[id] false where a counter is missing.
+	struct counterSample
+	{
+		double value[COUNTER_COUNT];
+		bool valid[COUNTER_COUNT];
+
+		counterSample()
+		{
+			for (int i = 0; i < COUNTER_COUNT; i++)
+			{
+				value[i] = 0.0;
+				valid[i] = false;
+			}
+		}
+
+		bool any() const
+		{
+			for (int i = 0; i < COUNTER_COUNT; i++)
+				if (valid[i])
+					return true;
+			return false;
+		}
+
+		counterSample operator- (const counterSample& rhs) const
+		{
+			counterSample d;
+			for (int i = 0; i < COUNTER_COUNT; i++)
+			{
+				d.valid[i] = valid[i] && rhs.valid[i];
+				d.value[i] = d.valid[i] ? value[i] - rhs.value[i] : 0.0;
+			}
+			return d;
+		}
+	};
+
+	class perfCounters
+	{
+	public:
+		static perfCounters& instance()
+		{
+			static perfCounters counters;
+			return counters;
+		}
+
+		bool available() const { return opened > 0; }
+		bool available(counterId id) const { return fd[id] >= 0; }
+		const std::string& error() const { return reason; }
+
+		counterSample read() const
+		{
+			counterSample s;
+#if defined(__linux__)
+			for (int i = 0; i < COUNTER_COUNT; i++)
+			{
+				// value, time enabled, time running.
+				std::uint64_t v[3];
+				if (fd[i] < 0 || ::read(fd[i], v, sizeof(v)) != static_cast<ssize_t>(sizeof(v)) || !v[2])
+					continue;
+				s.value[i] = v[2] < v[1] ? static_cast<double>(v[0]) * v[1] / v[2] : static_cast<double>(v[0]);
+				s.valid[i] = true;
+			}
+#endif
+			return s;
+		}
+
+		perfCounters(const perfCounters&) = delete;
+		perfCounters& operator= (const perfCounters&) = delete;
+
+	private:
+		int fd[COUNTER_COUNT];
+		int opened;
+		std::string reason;
+
+		perfCounters() : opened(0)
+		{
+			for (int i = 0; i < COUNTER_COUNT; i++)
+				fd[i] = -1;
+
+			const char* env = std::getenv("BENCH_COUNTERS");
+			if (env && std::string(env) == "0")
+			{
+				reason = "disabled by BENCH_COUNTERS=0";
+				return;
+			}
+#if defined(__linux__)
+			const std::uint64_t cacheReadMiss = (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+			open(CYCLES, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+			open(INSTRUCTIONS, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+			open(L1D_MISSES, PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | cacheReadMiss);
+			open(LLC_MISSES, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+			open(DTLB_MISSES, PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB | cacheReadMiss);
+			open(BRANCH_MISSES, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+#else
+			reason = "perf_event_open needs Linux";
+#endif
+		}
+
+		~perfCounters()
+		{
+#if defined(__linux__)
+			for (int i = 0; i < COUNTER_COUNT; i++)
+				if (fd[i] >= 0)
+					::close(fd[i]);
+#endif
+		}
+
+#if defined(__linux__)
+		void open(counterId id, std::uint32_t type, std::uint64_t config)
+		{
+			perf_event_attr attr;
+			std::memset(&attr, 0, sizeof(attr));
+			attr.size = sizeof(attr);
+			attr.type = type;
+			attr.config = config;
+			attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+			attr.inherit = 1;
+
+			// This thread, any cpu, no group.
+			long f = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+			if (f < 0)
+			{
+				if (reason.empty())
+					reason = std::string("perf_event_open: ") + std::strerror(errno);
+				return;
+			}
+			fd[id] = static_cast<int>(f);
+			opened++;
+		}
+#endif
+	};
+}
+
+#endif
@@ -0,0 +1,57 @@
+//
+// tree<T>::search_many vs. a loop of search(), as the tree outgrows the
+// caches.
+//
+//   search_many_bench [max keys] [lookups per call]
+//
+// Each size builds a balanced tree from random keys and searches random
+// keys, half of them present, in calls of the given size (default 256).
+//
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include "bench.h"
+#include "../tree_with_parent.h"
+
+int main(int argc, char* argv[])
+{
+	std::size_t maxKeys = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4000000;
+	std::size_t batch = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 256;
+	const std::size_t probes = 2000000;
+	bench::rng r(11);
+
+	if (batch == 0)
+		batch = 1;
+
+	bench::header();
+	for (std::size_t n = 10000; n <= maxKeys; n *= 4)
+	{
+		std::vector<int> keys(n);
+		for (std::size_t i = 0; i < n; i++)
+			keys[i] = static_cast<int>(r.next() >> 33) * 2;
+
+		tree<int> t;
+		t.insert_batch(keys.begin(), keys.end());
+
+		std::vector<int> lookups(probes);
+		for (std::size_t i = 0; i < probes; i++)
+			lookups[i] = keys[r.below(n)] + static_cast<int>(i & 1);
+		std::unique_ptr<bool[]> found(new bool[probes]);
+
+		std::size_t hits = 0;
+		bench::timer clock;
+		for (std::size_t i = 0; i < probes; i++)
+			hits += t.search(lookups[i]);
+		bench::report(bench::result{ "tree search loop", n, 1, probes, clock.seconds(), clock.counts() });
+
+		clock.reset();
+		for (std::size_t i = 0; i < probes; i += batch)
+			hits += t.search_many(&lookups[i], probes - i < batch ? probes - i : batch, &found[i]);
+		bench::report(bench::result{ "tree search_many", n, 1, probes, clock.seconds(), clock.counts() });
+
+		bench::keep(hits);
+	}
+
+	return 0;
+}
@@ -0,0 +1,94 @@
+//
+// simd::lowerBound vs. std::lower_bound and a scalar linear scan, per key
+// width and node size.
+//
+//   simd_search_bench [probes]
+//
+// Each case searches random keys in a set of node sized sorted arrays,
+// a different array per probe, as a tree descent would. Build with
+// -mavx2 (or /arch:AVX2) to measure the AVX2 kernels, SSE2 otherwise.
+//
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "../simd_search.h"
+
+const std::size_t ARRAYS = 1024;
+
+template <class T>
+void run(const char* type, std::size_t width, std::size_t probes)
+{
+	bench::rng r(width);
+	std::vector<T> keys(ARRAYS * width);
+	std::vector<T> targets(probes);
+	std::vector<std::size_t> which(probes);
+
+	for (std::size_t a = 0; a < ARRAYS; a++)
+		for (std::size_t i = 0; i < width; i++)
+			keys[a * width + i] = static_cast<T>(2 * static_cast<long long>(i) - static_cast<long long>(width));
+	for (std::size_t i = 0; i < probes; i++)
+	{
+		targets[i] = static_cast<T>(static_cast<long long>(r.below(2 * width + 2)) - static_cast<long long>(width) - 1);
+		which[i] = static_cast<std::size_t>(r.below(ARRAYS)) * width;
+	}
+
+	std::string name = std::string(type) + "/" + std::to_string(width);
+	std::size_t sum = 0;
+
+	bench::timer clock;
+	for (std::size_t i = 0; i < probes; i++)
+	{
+		const T* k = &keys[which[i]];
+		sum += std::lower_bound(k, k + width, targets[i]) - k;
+	}
+	bench::report(bench::result{ name + " std::lower_bound", width, 1, probes, clock.seconds(), clock.counts() });
+
+	clock.reset();
+	for (std::size_t i = 0; i < probes; i++)
+		sum += simd::counter<T, simd::OTHER>::less(&keys[which[i]], width, targets[i]);
+	bench::report(bench::result{ name + " linear", width, 1, probes, clock.seconds(), clock.counts() });
+
+	clock.reset();
+	for (std::size_t i = 0; i < probes; i++)
+	{
+		const T* k = &keys[which[i]];
+		sum += simd::lowerBound(k, k + width, targets[i]) - k;
+	}
+	bench::report(bench::result{ name + " simd::lowerBound", width, 1, probes, clock.seconds(), clock.counts() });
+
+	bench::keep(sum);
+}
+
+template <class T>
+void widths(const char* type, std::size_t probes)
+{
+	for (std::size_t width : { 8, 16, 32, 64 })
+		run<T>(type, width, probes);
+}
+
+int main(int argc, char* argv[])
+{
+	std::size_t probes = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000000;
+
+#if defined(SIMD_SEARCH_AVX2)
+	std::cout << "simd_search: AVX2\n";
+#elif defined(SIMD_SEARCH_SSE2)
+	std::cout << "simd_search: SSE2\n";
+#else
+	std::cout << "simd_search: scalar\n";
+#endif
+
+	bench::header();
+	widths<std::int8_t>("int8", probes);
+	widths<std::int16_t>("int16", probes);
+	widths<std::int32_t>("int32", probes);
+	widths<std::int64_t>("int64", probes);
+	widths<float>("float", probes);
+	widths<double>("double", probes);
+
+	return 0;
+}
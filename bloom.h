@@ -0,0 +1,173 @@
+/*************************************************************************
+* Title: Blocked Bloom Filter
+* File: bloom.h
+* Date: 10/18/2026
+*
+* Approximate membership filter answering "definitely absent" or "maybe
+* present" for hashed keys:
+*
+*   reset(keys, fpRate) // resize for keys at false positive rate, empty.
+*   clear()             // remove all keys, keep size.
+*   add(hash)           // add a key hash.
+*   mayContain(hash)    // false if the key was never added.
+*   bytes()             // filter size.
+*
+*   bloomHash(key)      // 64-bit hash of key via std::hash.
+*   bloomHashable<T>    // true if bloomHash supports T.
+*
+* Notes:
+*  (1) Blocked layout (Putze, Sanders & Singler): a key's bits all fall in
+*      one 64 byte, cache line aligned block, so add and mayContain touch
+*      a single cache line whatever the number of hash functions.
+*  (2) Keys are not stored, removal is not supported. Bits of removed
+*      keys only raise the false positive rate until the next reset.
+*  (3) Blocking concentrates bits, so the measured false positive rate is
+*      somewhat above the requested one; reset sizes with 20% extra bits
+*      to compensate.
+*************************************************************************
+* Change Log:
+*  10/18/2026: Initial release.
+*************************************************************************/
+#ifndef _BLOOM_H_
+#define _BLOOM_H_
+
+#include <cmath>       // log.
+#include <cstdint>     // fixed width words, hashes.
+#include <cstring>     // memcpy, memset.
+#include <functional>  // std::hash.
+#include <memory>      // bit storage.
+#include <stdexcept>   // invalid argument.
+#include <type_traits> // hash detection.
+
+class bloomFilter
+{
+public:
+	bloomFilter() : blocks(0), hashes(0) { }
+	bloomFilter(std::size_t keys, double fpRate) : blocks(0), hashes(0) { reset(keys, fpRate); }
+	bloomFilter(const bloomFilter& rhs) : blocks(0), hashes(0) { *this = rhs; }
+
+	bloomFilter& operator= (const bloomFilter& rhs)
+	{
+		if (this != &rhs)
+		{
+			allocate(rhs.blocks);
+			hashes = rhs.hashes;
+			if (blocks)
+				std::memcpy(base, rhs.base, blocks * BLOCK_BYTES);
+		}
+		return *this;
+	}
+
+	// Size for keys at false positive rate fpRate, 0 < fpRate < 1. Throws
+	// invalid_argument otherwise.
+	void reset(std::size_t keys, double fpRate)
+	{
+		if (!(fpRate > 0.0 && fpRate < 1.0))
+			throw std::invalid_argument("bloomFilter::reset: rate must be in (0, 1)");
+
+		const double ln2 = 0.6931471805599453;
+		double bits = 1.2 * (keys ? keys : 1) * -std::log(fpRate) / (ln2 * ln2);
+		int k = static_cast<int>(-std::log(fpRate) / ln2 + 0.5);
+
+		hashes = k < 1 ? 1 : k > MAX_HASHES ? MAX_HASHES : static_cast<unsigned>(k);
+		allocate(static_cast<std::size_t>(bits / BLOCK_BITS) + 1);
+		clear();
+	}
+
+	void clear()
+	{
+		if (blocks)
+			std::memset(base, 0, blocks * BLOCK_BYTES);
+	}
+
+	void add(std::uint64_t hash)
+	{
+		hash = mix(hash);
+		std::uint64_t* block = blockFor(hash);
+		std::uint32_t h1 = static_cast<std::uint32_t>(hash), h2 = static_cast<std::uint32_t>(hash >> 17) | 1;
+
+		for (unsigned i = 0; i < hashes; i++, h1 += h2)
+			block[(h1 & (BLOCK_BITS - 1)) >> 6] |= std::uint64_t(1) << (h1 & 63);
+	}
+
+	// False if hash was never added. Always true while unsized.
+	bool mayContain(std::uint64_t hash) const
+	{
+		if (!blocks)
+			return true;
+
+		hash = mix(hash);
+		const std::uint64_t* block = blockFor(hash);
+		std::uint32_t h1 = static_cast<std::uint32_t>(hash), h2 = static_cast<std::uint32_t>(hash >> 17) | 1;
+
+		for (unsigned i = 0; i < hashes; i++, h1 += h2)
+			if (!(block[(h1 & (BLOCK_BITS - 1)) >> 6] & (std::uint64_t(1) << (h1 & 63))))
+				return false;
+		return true;
+	}
+
+	std::size_t bytes() const { return blocks * BLOCK_BYTES; }
+	unsigned hashCount() const { return hashes; }
+
+private:
+	static const std::size_t BLOCK_BYTES = 64;
+	static const std::uint32_t BLOCK_BITS = 512;
+	static const int MAX_HASHES = 16;
+
+	// Storage over-allocated by a block, base is its first aligned word.
+	std::unique_ptr<std::uint64_t[]> storage;
+	std::uint64_t* base = nullptr;
+	std::size_t blocks;
+	unsigned hashes;
+
+	void allocate(std::size_t n)
+	{
+		if (n == blocks)
+			return;
+
+		const std::size_t words = BLOCK_BYTES / sizeof(std::uint64_t);
+		storage.reset(n ? new std::uint64_t[(n + 1) * words] : nullptr);
+		blocks = n;
+		base = storage.get();
+		if (base)
+		{
+			std::uintptr_t a = reinterpret_cast<std::uintptr_t>(base);
+			base += (BLOCK_BYTES - a % BLOCK_BYTES) % BLOCK_BYTES / sizeof(std::uint64_t);
+		}
+	}
+
+	// Block chosen by the high half, bits within it by the low half.
+	std::uint64_t* blockFor(std::uint64_t hash) const
+	{
+		std::size_t i = static_cast<std::size_t>(((hash >> 32) * blocks) >> 32);
+		return base + i * (BLOCK_BYTES / sizeof(std::uint64_t));
+	}
+
+	// std::hash is often the identity for integers, spread it first.
+	static std::uint64_t mix(std::uint64_t h)
+	{
+		h ^= h >> 33;
+		h *= 0xFF51AFD7ED558CCDull;
+		h ^= h >> 33;
+		h *= 0xC4CEB9FE1A85EC53ull;
+		h ^= h >> 33;
+		return h;
+	}
+};
+
+template <class T>
+struct bloomHashable : std::is_default_constructible<std::hash<T>> { };
+
+template <class T>
+std::uint64_t bloomHash(const T& key, std::true_type) { return std::hash<T>()(key); }
+
+template <class T>
+std::uint64_t bloomHash(const T&, std::false_type) { return 0; }
+
+template <class T>
+std::uint64_t bloomHash(const T& key)
+{
+	return bloomHash(key, std::integral_constant<bool, bloomHashable<T>::value>());
+}
+
+#endif
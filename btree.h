@@ -0,0 +1,709 @@
+/*************************************************************************
+* Title: Paged B+Tree
+* File: btree.h
+* Date: 10/18/2026
+*
+* External memory ordered set. Keys live in fixed size pages of a local
+* file, all keys in leaves, leaves chained left to right for sequential
+* scans. Only the pages held by an LRU buffer pool are resident, so the
+* set may be far larger than memory. Exposes the set<T> operations:
+*
+*   create(path, budget) // create (or truncate) file, budget in bytes.
+*   open(path, budget)   // open existing file.
+*   flush()       // write dirty pages and file header.
+*   close()       // flush and close file.
+*   empty()       // returns true if set is empty.
+*   size()        // number of keys, O(1).
+*   insert(T)     // insert T, returns false if T already present.
+*   search(T)     // returns true if T is present.
+*   lowerBound()  // smallest key.
+*   upperBound()  // largest key.
+*   lowerBound(T) // iterator to first key not less than T.
+*   begin()/end() // in-order forward iteration along the leaf chain.
+*   getHeight()   // levels, 1 for a single leaf.
+*
+* Notes:
+*  (1) T must be trivially copyable, keys are stored as raw bytes in
+*      native byte order. Page 0 holds a header recording the layout,
+*      open() rejects files written with a different one.
+*  (2) Keys equal to an inner node separator are found in its right
+*      subtree. Splits move the upper half of a node to a new right
+*      sibling, so the leftmost leaf is always page 1.
+*  (3) The buffer pool never holds fewer than bufferPool::MIN_FRAMES
+*      pages. Operations pin at most three pages at a time.
+*  (4) Iterators copy the current key, so they stay valid while the pool
+*      evicts pages, but not across insert().
+*  (5) Removal is not supported.
+*************************************************************************
+* Change Log:
+*  10/18/2026: Initial release.
+*  10/18/2026: Node searches use simd::lowerBound/upperBound.
+*************************************************************************/
+#ifndef _BTREE_H_
+#define _BTREE_H_
+
+#include <cstdint>       // fixed width page fields.
+#include <cstring>       // memcpy, memmove, memset.
+#include <fstream>       // page file.
+#include <iterator>      // iterator tags.
+#include <list>          // lru order.
+#include <memory>        // frame memory.
+#include <stdexcept>     // runtime error, out of range.
+#include <string>        // file paths.
+#include <type_traits>   // is_trivially_copyable.
+#include <unordered_map> // page table.
+#include <vector>        // frames, split buffers.
+#include "simd_search.h"
+
+// Fixed size page cache over a file, least recently used pages evicted
+// first. Pages are pinned while in use and never evicted while pinned.
+class bufferPool
+{
+public:
+	static const std::size_t PAGE_SIZE = 4096;
+	static const std::size_t MIN_FRAMES = 8;
+
+	// Pool counters.
+	struct counters
+	{
+		std::uint64_t hits;   // fetches served from memory.
+		std::uint64_t misses; // fetches that read the file.
+		std::uint64_t writes; // pages written back.
+		std::size_t frames;   // pool capacity in pages.
+	};
+
+	// Pinned page, unpinned when destroyed.
+	class page
+	{
+	public:
+		page() : pool(nullptr), id(0), index(0) { }
+		page(bufferPool* p, std::uint64_t i, std::size_t f) : pool(p), id(i), index(f) { }
+		page(page&& rhs) : pool(rhs.pool), id(rhs.id), index(rhs.index) { rhs.pool = nullptr; }
+		page& operator= (page&& rhs)
+		{
+			if (this != &rhs)
+			{
+				release();
+				pool = rhs.pool;
+				id = rhs.id;
+				index = rhs.index;
+				rhs.pool = nullptr;
+			}
+			return *this;
+		}
+		page(const page&) = delete;
+		page& operator= (const page&) = delete;
+		~page() { release(); }
+
+		std::uint64_t pageId() const { return id; }
+		char* get() const { return pool->slot(index); }
+		// Mark page modified, it is written back before eviction.
+		void dirty() { pool->frames[index].dirty = true; }
+
+	private:
+		void release()
+		{
+			if (pool)
+				pool->frames[index].pins--;
+			pool = nullptr;
+		}
+
+		bufferPool* pool;
+		std::uint64_t id;
+		std::size_t index; // Frame holding the page.
+	};
+
+	bufferPool() : pages(0), hits(0), misses(0), writes(0) { }
+	~bufferPool() { close(); }
+
+	bufferPool(const bufferPool&) = delete;
+	bufferPool& operator= (const bufferPool&) = delete;
+
+	// Open page file, budget is the pool memory in bytes.
+	void open(const std::string& path, bool truncate, std::size_t budget)
+	{
+		close();
+
+		std::ios::openmode mode = std::ios::in | std::ios::out | std::ios::binary;
+		if (truncate)
+			mode |= std::ios::trunc;
+		file.open(path, mode);
+		if (!file)
+			throw std::runtime_error("bufferPool: cannot open " + path);
+
+		file.seekg(0, std::ios::end);
+		pages = static_cast<std::uint64_t>(file.tellg()) / PAGE_SIZE;
+
+		std::size_t n = budget / PAGE_SIZE < MIN_FRAMES ? MIN_FRAMES : budget / PAGE_SIZE;
+		memory.reset(new char[n * PAGE_SIZE]);
+		frames.assign(n, frame());
+		free.clear();
+		for (std::size_t i = n; i > 0; i--)
+			free.push_back(i - 1);
+		table.clear();
+		lru.clear();
+		hits = misses = writes = 0;
+	}
+
+	// Write back dirty pages, drop the pool and close the file.
+	void close()
+	{
+		if (!file.is_open())
+			return;
+
+		flush();
+		file.close();
+		memory.reset();
+		frames.clear();
+		table.clear();
+		lru.clear();
+	}
+
+	// Write back all dirty pages.
+	void flush()
+	{
+		for (std::size_t i = 0; i < frames.size(); i++)
+			if (frames[i].dirty)
+				writeBack(i);
+		file.flush();
+		if (!file)
+			throw std::runtime_error("bufferPool: write failed");
+	}
+
+	// Pin page id, reading it from the file if not resident.
+	page fetch(std::uint64_t id)
+	{
+		std::unordered_map<std::uint64_t, std::size_t>::iterator it = table.find(id);
+
+		if (it != table.end())
+		{
+			frame& f = frames[it->second];
+			hits++;
+			f.pins++;
+			lru.splice(lru.begin(), lru, f.pos);
+			return page(this, id, it->second);
+		}
+
+		if (id >= pages)
+			throw std::out_of_range("bufferPool: page beyond end of file");
+
+		misses++;
+		std::size_t i = victim(id);
+		file.seekg(static_cast<std::streamoff>(id * PAGE_SIZE));
+		if (!file.read(slot(i), PAGE_SIZE))
+		{
+			file.clear();
+			unmap(i);
+			throw std::runtime_error("bufferPool: read failed");
+		}
+
+		return page(this, id, i);
+	}
+
+	// Append a new zeroed page to the file and pin it.
+	page allocate()
+	{
+		std::uint64_t id = pages;
+		std::size_t i = victim(id);
+
+		pages++;
+		std::memset(slot(i), 0, PAGE_SIZE);
+		frames[i].dirty = true;
+
+		return page(this, id, i);
+	}
+
+	std::uint64_t pageCount() const { return pages; }
+	counters stats() const { return counters{ hits, misses, writes, frames.size() }; }
+
+private:
+	struct frame
+	{
+		std::uint64_t id = 0;
+		unsigned pins = 0;
+		bool dirty = false;
+		std::list<std::size_t>::iterator pos;
+	};
+
+	char* slot(std::size_t i) { return memory.get() + i * PAGE_SIZE; }
+
+	// Claim a frame for page id, pinned, evicting the least recently used
+	// unpinned page if no frame is free.
+	std::size_t victim(std::uint64_t id)
+	{
+		std::size_t i;
+
+		if (free.size())
+		{
+			i = free.back();
+			free.pop_back();
+		}
+		else
+		{
+			std::list<std::size_t>::reverse_iterator r = lru.rbegin();
+			while (r != lru.rend() && frames[*r].pins)
+				++r;
+			if (r == lru.rend())
+				throw std::runtime_error("bufferPool: all pages pinned");
+
+			i = *r;
+			if (frames[i].dirty)
+				writeBack(i);
+			table.erase(frames[i].id);
+			lru.erase(frames[i].pos);
+		}
+
+		frames[i].id = id;
+		frames[i].pins = 1;
+		frames[i].dirty = false;
+		lru.push_front(i);
+		frames[i].pos = lru.begin();
+		table[id] = i;
+
+		return i;
+	}
+
+	// Return frame i to the free list.
+	void unmap(std::size_t i)
+	{
+		table.erase(frames[i].id);
+		lru.erase(frames[i].pos);
+		frames[i] = frame();
+		free.push_back(i);
+	}
+
+	void writeBack(std::size_t i)
+	{
+		file.seekp(static_cast<std::streamoff>(frames[i].id * PAGE_SIZE));
+		if (!file.write(slot(i), PAGE_SIZE))
+			throw std::runtime_error("bufferPool: write failed");
+		frames[i].dirty = false;
+		writes++;
+	}
+
+	std::fstream file;
+	std::uint64_t pages;
+	std::unique_ptr<char[]> memory;
+	std::vector<frame> frames;
+	std::vector<std::size_t> free;
+	std::unordered_map<std::uint64_t, std::size_t> table;
+	std::list<std::size_t> lru; // Most recently used first.
+	std::uint64_t hits, misses, writes;
+};
+
+template <class T>
+class btree
+{
+	static_assert(std::is_trivially_copyable<T>::value, "btree requires trivially copyable T");
+
+	static const std::size_t PAGE_SIZE = bufferPool::PAGE_SIZE;
+
+	// Page 0.
+	struct fileHeader
+	{
+		char magic[4];
+		std::uint32_t version;
+		std::uint32_t byteOrder;
+		std::uint32_t keySize;
+		std::uint32_t pageSize;
+		std::uint32_t height;
+		std::uint64_t root;
+		std::uint64_t count;
+	};
+
+	// Start of every node page. Leaves: keys follow. Inner nodes: n + 1
+	// child page ids follow, then n separator keys.
+	struct nodeHeader
+	{
+		std::uint16_t leaf;
+		std::uint16_t n;
+		std::uint32_t reserved;
+		std::uint64_t next; // Right sibling leaf, 0 for the last leaf.
+	};
+
+	static const std::size_t KEY_ALIGN = alignof(T) < 8 ? 8 : alignof(T);
+	static const std::size_t LEAF_KEYS = (sizeof(nodeHeader) + KEY_ALIGN - 1) / KEY_ALIGN * KEY_ALIGN;
+	static const std::size_t LEAF_MAX = (PAGE_SIZE - LEAF_KEYS) / sizeof(T);
+	static const std::size_t INNER_MAX = (PAGE_SIZE - sizeof(nodeHeader) - 8 - KEY_ALIGN) / (8 + sizeof(T));
+	static const std::size_t INNER_KEYS = (sizeof(nodeHeader) + 8 * (INNER_MAX + 1) + KEY_ALIGN - 1) / KEY_ALIGN * KEY_ALIGN;
+
+	static_assert(LEAF_MAX >= 3 && INNER_MAX >= 3, "btree key type too large for page");
+
+	static const std::uint32_t FILE_VERSION = 1;
+	static const std::uint32_t FILE_BYTE_ORDER = 0x01020304;
+	static const std::uint64_t FIRST_LEAF = 1;
+	static const char* fileMagic() { return "BPTF"; }
+
+	static nodeHeader* node(char* p) { return reinterpret_cast<nodeHeader*>(p); }
+	static T* keys(char* p) { return reinterpret_cast<T*>(p + (node(p)->leaf ? LEAF_KEYS : INNER_KEYS)); }
+	static std::uint64_t* children(char* p) { return reinterpret_cast<std::uint64_t*>(p + sizeof(nodeHeader)); }
+
+public:
+	class iterator;
+	typedef iterator const_iterator;
+
+	// Default buffer pool budget, in bytes.
+	static const std::size_t DEFAULT_BUDGET = 64 << 20;
+
+	btree() : root(0), height(0), count(0) { }
+	~btree() { close(); }
+
+	btree(const btree<T>&) = delete;
+	const btree<T>& operator= (const btree<T>&) = delete;
+
+	//
+	// File management.
+	//
+
+	// Create or truncate file at path, budget caps the buffer pool memory.
+	void create(const std::string& path, std::size_t budget = DEFAULT_BUDGET)
+	{
+		pool.open(path, true, budget);
+
+		bufferPool::page h = pool.allocate();
+		bufferPool::page leaf = pool.allocate();
+		node(leaf.get())->leaf = 1;
+
+		root = leaf.pageId();
+		height = 1;
+		count = 0;
+		writeHeader(h);
+	}
+
+	// Open existing file. Throws runtime_error if it is missing, malformed
+	// or was written with a different key layout.
+	void open(const std::string& path, std::size_t budget = DEFAULT_BUDGET)
+	{
+		pool.open(path, false, budget);
+
+		try
+		{
+			if (pool.pageCount() < 2)
+				throw std::runtime_error("btree::open: truncated file");
+
+			bufferPool::page p = pool.fetch(0);
+			fileHeader h;
+			std::memcpy(&h, p.get(), sizeof(h));
+
+			if (std::memcmp(h.magic, fileMagic(), sizeof(h.magic)) != 0)
+				throw std::runtime_error("btree::open: not a btree file");
+			if (h.version != FILE_VERSION)
+				throw std::runtime_error("btree::open: unsupported version");
+			if (h.byteOrder != FILE_BYTE_ORDER || h.keySize != sizeof(T) || h.pageSize != PAGE_SIZE)
+				throw std::runtime_error("btree::open: incompatible key layout");
+			if (h.root == 0 || h.root >= pool.pageCount() || h.height == 0)
+				throw std::runtime_error("btree::open: corrupt header");
+
+			root = h.root;
+			height = h.height;
+			count = h.count;
+		}
+		catch (...)
+		{
+			pool.close();
+			throw;
+		}
+	}
+
+	// Write dirty pages and file header.
+	void flush()
+	{
+		bufferPool::page h = pool.fetch(0);
+		writeHeader(h);
+		pool.flush();
+	}
+
+	void close()
+	{
+		if (root)
+			flush();
+		pool.close();
+		root = 0;
+		height = count = 0;
+	}
+
+	//
+	// Set operations.
+	//
+
+	bool empty() const { return count == 0; }
+	std::size_t size() const { return static_cast<std::size_t>(count); }
+	int getHeight() const { return static_cast<int>(height); }
+
+	// Insert data, returns false if already present.
+	bool insert(const T& data)
+	{
+		// Descend to the leaf, remembering the path.
+		std::uint64_t path[64];
+		unsigned slots[64];
+		unsigned depth = 0;
+		bufferPool::page p = pool.fetch(root);
+
+		while (!node(p.get())->leaf)
+		{
+			char* n = p.get();
+			unsigned i = static_cast<unsigned>(simd::upperBound(keys(n), keys(n) + node(n)->n, data) - keys(n));
+
+			path[depth] = p.pageId();
+			slots[depth++] = i;
+			p = pool.fetch(children(n)[i]);
+		}
+
+		char* leaf = p.get();
+		T* k = keys(leaf);
+		std::size_t n = node(leaf)->n;
+		std::size_t pos = simd::lowerBound(k, k + n, data) - k;
+
+		if (pos < n && !(data < k[pos]))
+			return false;
+
+		count++;
+		p.dirty();
+		if (n < LEAF_MAX)
+		{
+			std::memmove(k + pos + 1, k + pos, (n - pos) * sizeof(T));
+			k[pos] = data;
+			node(leaf)->n++;
+			return true;
+		}
+
+		// Split full leaf, upper half moves to a new right sibling.
+		std::vector<T> all(k, k + n);
+		all.insert(all.begin() + pos, data);
+
+		bufferPool::page right = pool.allocate();
+		std::size_t half = all.size() / 2;
+
+		node(right.get())->leaf = 1;
+		node(right.get())->n = static_cast<std::uint16_t>(all.size() - half);
+		node(right.get())->next = node(leaf)->next;
+		std::memcpy(keys(right.get()), &all[half], (all.size() - half) * sizeof(T));
+
+		node(leaf)->n = static_cast<std::uint16_t>(half);
+		node(leaf)->next = right.pageId();
+		std::memcpy(k, &all[0], half * sizeof(T));
+
+		T separator = all[half];
+		std::uint64_t child = right.pageId();
+
+		// Insert separator into parents, splitting them as needed.
+		while (depth)
+		{
+			--depth;
+			p = pool.fetch(path[depth]);
+			p.dirty();
+
+			char* in = p.get();
+			std::size_t m = node(in)->n, i = slots[depth];
+			T* ik = keys(in);
+			std::uint64_t* ic = children(in);
+
+			if (m < INNER_MAX)
+			{
+				std::memmove(ik + i + 1, ik + i, (m - i) * sizeof(T));
+				std::memmove(ic + i + 2, ic + i + 1, (m - i) * sizeof(std::uint64_t));
+				ik[i] = separator;
+				ic[i + 1] = child;
+				node(in)->n++;
+				return true;
+			}
+
+			std::vector<T> sk(ik, ik + m);
+			std::vector<std::uint64_t> sc(ic, ic + m + 1);
+			sk.insert(sk.begin() + i, separator);
+			sc.insert(sc.begin() + i + 1, child);
+
+			// Middle key moves up, it is not kept in either half.
+			std::size_t mid = sk.size() / 2;
+			bufferPool::page sibling = pool.allocate();
+			char* sn = sibling.get();
+
+			node(sn)->n = static_cast<std::uint16_t>(sk.size() - mid - 1);
+			std::memcpy(children(sn), &sc[mid + 1], (sk.size() - mid) * sizeof(std::uint64_t));
+			std::memcpy(keys(sn), &sk[mid + 1], (sk.size() - mid - 1) * sizeof(T));
+
+			node(in)->n = static_cast<std::uint16_t>(mid);
+			std::memcpy(ic, &sc[0], (mid + 1) * sizeof(std::uint64_t));
+			std::memcpy(ik, &sk[0], mid * sizeof(T));
+
+			separator = sk[mid];
+			child = sibling.pageId();
+		}
+
+		// Root split, tree grows a level.
+		bufferPool::page top = pool.allocate();
+		char* tn = top.get();
+
+		node(tn)->n = 1;
+		children(tn)[0] = root;
+		children(tn)[1] = child;
+		keys(tn)[0] = separator;
+		root = top.pageId();
+		height++;
+
+		return true;
+	}
+
+	// Returns true if data is present.
+	bool search(const T& data) const
+	{
+		bufferPool::page p = leafFor(data);
+		T* k = keys(p.get());
+		T* end = k + node(p.get())->n;
+		T* it = simd::lowerBound(k, end, data);
+
+		return it != end && !(data < *it);
+	}
+
+	// Smallest key. Throws out_of_range if empty.
+	T lowerBound() const
+	{
+		if (empty())
+			throw std::out_of_range("btree::lowerBound: empty");
+		return *begin();
+	}
+
+	// Largest key. Throws out_of_range if empty.
+	T upperBound() const
+	{
+		if (empty())
+			throw std::out_of_range("btree::upperBound: empty");
+
+		bufferPool::page p = pool.fetch(root);
+		while (!node(p.get())->leaf)
+			p = pool.fetch(children(p.get())[node(p.get())->n]);
+
+		return keys(p.get())[node(p.get())->n - 1];
+	}
+
+	// Iterator to first key not less than data, end() if none.
+	iterator lowerBound(const T& data) const
+	{
+		bufferPool::page p = leafFor(data);
+		T* k = keys(p.get());
+		std::size_t i = simd::lowerBound(k, k + node(p.get())->n, data) - k;
+
+		return iterator(this, p.pageId(), i);
+	}
+
+	//
+	// Iterators.
+	//
+
+	iterator begin() const { return iterator(this, FIRST_LEAF, 0); }
+	iterator end() const { return iterator(); }
+	const_iterator cbegin() const { return begin(); }
+	const_iterator cend() const { return end(); }
+
+	// Buffer pool counters.
+	bufferPool::counters poolStats() const { return pool.stats(); }
+
+private:
+	// Pages are cached by searches too, the pool is not part of the value.
+	mutable bufferPool pool;
+	std::uint64_t root;
+	std::uint64_t height;
+	std::uint64_t count;
+
+	// Descend to the leaf that would hold data.
+	bufferPool::page leafFor(const T& data) const
+	{
+		bufferPool::page p = pool.fetch(root);
+
+		while (!node(p.get())->leaf)
+		{
+			char* n = p.get();
+			std::size_t i = simd::upperBound(keys(n), keys(n) + node(n)->n, data) - keys(n);
+			p = pool.fetch(children(n)[i]);
+		}
+
+		return p;
+	}
+
+	void writeHeader(bufferPool::page& p)
+	{
+		fileHeader h;
+
+		std::memset(&h, 0, sizeof(h));
+		std::memcpy(h.magic, fileMagic(), sizeof(h.magic));
+		h.version = FILE_VERSION;
+		h.byteOrder = FILE_BYTE_ORDER;
+		h.keySize = sizeof(T);
+		h.pageSize = PAGE_SIZE;
+		h.height = static_cast<std::uint32_t>(height);
+		h.root = root;
+		h.count = count;
+
+		std::memcpy(p.get(), &h, sizeof(h));
+		p.dirty();
+	}
+};
+
+// Forward iterator along the leaf chain. Holds a copy of the current key,
+// pages are fetched only when stepping.
+template <class T>
+class btree<T>::iterator
+{
+	friend class btree<T>;
+
+public:
+	typedef std::forward_iterator_tag iterator_category;
+	typedef T value_type;
+	typedef std::ptrdiff_t difference_type;
+	typedef const T* pointer;
+	typedef const T& reference;
+
+	iterator() : owner(nullptr), leaf(0), slot(0), key() { }
+
+	reference operator*() const { return key; }
+	pointer operator->() const { return &key; }
+
+	iterator& operator++()
+	{
+		slot++;
+		settle();
+		return *this;
+	}
+	iterator operator++(int)
+	{
+		iterator old = *this;
+		++*this;
+		return old;
+	}
+
+	bool operator== (const iterator& rhs) const { return leaf == rhs.leaf && slot == rhs.slot; }
+	bool operator!= (const iterator& rhs) const { return !(*this == rhs); }
+
+private:
+	iterator(const btree<T>* t, std::uint64_t l, std::size_t s) : owner(t), leaf(l), slot(s), key()
+	{
+		settle();
+	}
+
+	// Load key at (leaf, slot), moving along the chain past the end of a
+	// leaf. Becomes end() after the last key.
+	void settle()
+	{
+		while (leaf)
+		{
+			bufferPool::page p = owner->pool.fetch(leaf);
+			char* n = p.get();
+
+			if (slot < node(n)->n)
+			{
+				key = keys(n)[slot];
+				return;
+			}
+
+			leaf = node(n)->next;
+			slot = 0;
+		}
+	}
+
+	const btree<T>* owner;
+	std::uint64_t leaf;
+	std::size_t slot;
+	T key;
+};
+
+#endif
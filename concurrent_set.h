@@ -0,0 +1,596 @@
+/*************************************************************************
+* Title: Concurrent Set
+* File: concurrent_set.h
+* Date: 10/18/2026
+*
+* Lock-free ordered set built on a skip list (Herlihy, Lev, Luchangco &
+* Shavit). Exposes the same surface as set<T>:
+*
+*   add(T)        // insert T, returns false if T already present.
+*   insert(T)     // same as add, set<T> naming.
+*   remove(T)     // remove T, returns true if T was present.
+*   search(T)     // returns true if T is present (wait-free).
+*   size()        // number of elements (approximate while mutating).
+*   lowerBound()  // smallest element.
+*   upperBound()  // largest element.
+*   begin()/end() // weakly consistent in-order iteration.
+*
+* Notes:
+*  (1) Each node link carries a "marked" flag in its low bit. remove()
+*      marks a node's links top-down, the level 0 mark being the
+*      linearization point. Traversals physically unlink marked nodes.
+*  (2) Memory is reclaimed through an epoch-based reclamation (EBR)
+*      domain. Every operation pins the calling thread to the current
+*      epoch; unlinked nodes are retired and freed once the global epoch
+*      has advanced twice past the epoch they were retired in.
+*  (3) A node is retired only after both its inserter has finished
+*      linking it and its remover has swept it out of every level. Each
+*      side holds one token, the last to let go retires the node.
+*  (4) Iterators pin the thread while they live, keep them short lived
+*      and do not hand them to other threads.
+*  (5) At most ebr::MAX_THREADS threads may use the domain at once.
+*************************************************************************
+* Change Log:
+*  10/18/2026: Initial release.
+*************************************************************************/
+#ifndef _CONCURRENT_SET_H_
+#define _CONCURRENT_SET_H_
+
+#include <atomic>    // atomic links and epochs.
+#include <cstdint>   // uintptr_t.
+#include <iterator>  // iterator tags.
+#include <mutex>     // orphaned retire list.
+#include <new>       // placement new.
+#include <stdexcept> // out of range, runtime error.
+#include <vector>    // retire lists.
+
+namespace ebr
+{
+	// Maximum number of threads concurrently registered with the domain.
+	const std::size_t MAX_THREADS = 128;
+	// Retired objects a thread accumulates before attempting a collection.
+	const std::size_t COLLECT_THRESHOLD = 64;
+
+	// An object waiting for reclamation.
+	struct retired
+	{
+		void* ptr;
+		void (*destroy)(void*);
+		std::uint64_t epoch;
+	};
+
+	// Per-thread announcement slot, padded to a cache line.
+	struct alignas(64) slot
+	{
+		std::atomic<std::uint64_t> epoch{ 0 }; // 0 when quiescent.
+		std::atomic<bool> used{ false };
+	};
+
+	class domain
+	{
+	public:
+		static domain& instance()
+		{
+			static domain d;
+			return d;
+		}
+
+		slot* acquireSlot()
+		{
+			for (std::size_t i = 0; i < MAX_THREADS; i++)
+			{
+				bool expected = false;
+				if (!slots[i].used.load() && slots[i].used.compare_exchange_strong(expected, true))
+					return &slots[i];
+			}
+			throw std::runtime_error("ebr: too many threads");
+		}
+
+		void releaseSlot(slot* s, std::vector<retired>& limbo)
+		{
+			s->epoch.store(0);
+			s->used.store(false);
+
+			std::lock_guard<std::mutex> lock(orphanLock);
+			orphans.insert(orphans.end(), limbo.begin(), limbo.end());
+			limbo.clear();
+		}
+
+		// Announce the calling thread as active in the current epoch.
+		void pin(slot* s)
+		{
+			std::uint64_t e;
+			do {
+				e = epoch.load();
+				s->epoch.store(e);
+			} while (epoch.load() != e);
+		}
+
+		void unpin(slot* s) { s->epoch.store(0); }
+
+		std::uint64_t current() const { return epoch.load(); }
+
+		// Advance global epoch if every active thread has observed it.
+		void tryAdvance()
+		{
+			std::uint64_t e = epoch.load();
+
+			for (std::size_t i = 0; i < MAX_THREADS; i++)
+			{
+				std::uint64_t local = slots[i].epoch.load();
+				if (local != 0 && local != e)
+					return;
+			}
+			epoch.compare_exchange_strong(e, e + 1);
+		}
+
+		// Free every object in list that no thread can still reference.
+		void reclaim(std::vector<retired>& list)
+		{
+			std::uint64_t e = epoch.load();
+			std::size_t kept = 0;
+
+			for (std::size_t i = 0; i < list.size(); i++)
+			{
+				if (list[i].epoch + 2 <= e)
+					list[i].destroy(list[i].ptr);
+				else
+					list[kept++] = list[i];
+			}
+			list.resize(kept);
+		}
+
+		void collect(std::vector<retired>& limbo)
+		{
+			tryAdvance();
+			reclaim(limbo);
+
+			std::unique_lock<std::mutex> lock(orphanLock, std::try_to_lock);
+			if (lock.owns_lock())
+				reclaim(orphans);
+		}
+
+	private:
+		domain() = default;
+		~domain()
+		{
+			// Process exit, no thread can be inside a critical section.
+			for (std::size_t i = 0; i < orphans.size(); i++)
+				orphans[i].destroy(orphans[i].ptr);
+		}
+
+		std::atomic<std::uint64_t> epoch{ 1 };
+		slot slots[MAX_THREADS];
+		std::mutex orphanLock;
+		std::vector<retired> orphans;
+	};
+
+	// Thread local registration, created on first use.
+	struct threadRecord
+	{
+		slot* s = nullptr;
+		unsigned nesting = 0;
+		std::vector<retired> limbo;
+
+		~threadRecord()
+		{
+			if (s)
+				domain::instance().releaseSlot(s, limbo);
+		}
+	};
+
+	inline threadRecord& local()
+	{
+		thread_local threadRecord record;
+		return record;
+	}
+
+	// RAII critical section. Guards nest on the same thread.
+	class guard
+	{
+	public:
+		guard() { enter(); }
+		guard(const guard&) { enter(); }
+		guard& operator= (const guard&) { return *this; }
+		~guard()
+		{
+			threadRecord& r = local();
+			if (--r.nesting == 0)
+				domain::instance().unpin(r.s);
+		}
+
+	private:
+		static void enter()
+		{
+			threadRecord& r = local();
+			if (r.nesting++ == 0)
+			{
+				if (!r.s)
+					r.s = domain::instance().acquireSlot();
+				domain::instance().pin(r.s);
+			}
+		}
+	};
+
+	// Hand an unlinked object to the domain. Caller must hold a guard.
+	inline void retire(void* p, void (*destroy)(void*))
+	{
+		threadRecord& r = local();
+		r.limbo.push_back(retired{ p, destroy, domain::instance().current() });
+
+		if (r.limbo.size() >= COLLECT_THRESHOLD)
+			domain::instance().collect(r.limbo);
+	}
+}
+
+template <class T>
+class concurrentSet
+{
+private:
+	// Maximum tower height, supports ~2^24 elements at full efficiency.
+	static const int MAX_LEVEL = 24;
+
+	typedef std::atomic<std::uintptr_t> link;
+
+	struct alignas(link) Node
+	{
+		T data;
+		int height;
+		std::atomic<int> tokens; // Inserter + remover, see note (3).
+
+		Node(const T& d, int h) : data(d), height(h), tokens(2) { }
+
+		// Tower of next links allocated directly behind the node.
+		link* next() { return reinterpret_cast<link*>(this + 1); }
+	};
+
+	static Node* ptr(std::uintptr_t l) { return reinterpret_cast<Node*>(l & ~std::uintptr_t(1)); }
+	static bool marked(std::uintptr_t l) { return (l & 1) != 0; }
+	static std::uintptr_t bits(Node* n, bool mark = false) { return reinterpret_cast<std::uintptr_t>(n) | (mark ? 1 : 0); }
+
+public:
+	concurrentSet() : count(0)
+	{
+		for (int i = 0; i < MAX_LEVEL; i++)
+			head[i].store(0);
+	}
+	~concurrentSet() { clear(); }
+
+	concurrentSet(const concurrentSet&) = delete;
+	concurrentSet& operator= (const concurrentSet&) = delete;
+
+	//
+	// Basic set functionality.
+	//
+
+	bool add(const T& data)
+	{
+		ebr::guard g;
+		link* preds[MAX_LEVEL];
+		Node* succs[MAX_LEVEL];
+		int height = randomLevel();
+		Node* node = nullptr;
+
+		while (true)
+		{
+			if (find(data, preds, succs))
+			{
+				if (node)
+					destroy(node);
+				return false;
+			}
+
+			if (!node)
+				node = create(data, height);
+			for (int i = 0; i < height; i++)
+				node->next()[i].store(bits(succs[i]));
+
+			// Linearization point, publish on the bottom level.
+			std::uintptr_t expected = bits(succs[0]);
+			if (preds[0][0].compare_exchange_strong(expected, bits(node)))
+				break;
+		}
+		++count;
+
+		// Link upper levels, giving up as soon as the node is being removed.
+		for (int i = 1; i < height; i++)
+		{
+			while (true)
+			{
+				std::uintptr_t succ = node->next()[i].load();
+				if (marked(succ))
+					goto linked;
+				if (ptr(succ) != succs[i] && !node->next()[i].compare_exchange_strong(succ, bits(succs[i])))
+					goto linked;
+
+				std::uintptr_t expected = bits(succs[i]);
+				if (preds[i][i].compare_exchange_strong(expected, bits(node)))
+					break;
+
+				find(data, preds, succs);
+				if (succs[0] != node)
+					goto linked; // Removed and unlinked under us.
+			}
+		}
+
+	linked:
+		// A remover may have swept before we finished linking, sweep again.
+		if (marked(node->next()[0].load()))
+			find(data, preds, succs);
+		release(node);
+
+		return true;
+	}
+
+	void insert(const T& data) { add(data); }
+
+	bool remove(const T& data)
+	{
+		ebr::guard g;
+		link* preds[MAX_LEVEL];
+		Node* succs[MAX_LEVEL];
+
+		if (!find(data, preds, succs))
+			return false;
+
+		Node* node = succs[0];
+
+		// Mark upper levels top-down.
+		for (int i = node->height - 1; i > 0; i--)
+		{
+			std::uintptr_t succ = node->next()[i].load();
+			while (!marked(succ))
+			{
+				node->next()[i].compare_exchange_weak(succ, succ | 1);
+				succ = node->next()[i].load();
+			}
+		}
+
+		// Mark bottom level, the thread that succeeds owns the removal.
+		std::uintptr_t succ = node->next()[0].load();
+		while (true)
+		{
+			if (marked(succ))
+				return false; // Another thread removed it first.
+			if (node->next()[0].compare_exchange_strong(succ, succ | 1))
+				break;
+		}
+		--count;
+
+		// Physically unlink from every level.
+		find(data, preds, succs);
+		release(node);
+
+		return true;
+	}
+
+	bool search(const T& data) const
+	{
+		ebr::guard g;
+		const link* pred = head;
+		Node* curr = nullptr;
+
+		for (int level = MAX_LEVEL - 1; level >= 0; level--)
+		{
+			curr = ptr(pred[level].load());
+
+			while (curr)
+			{
+				std::uintptr_t succ = curr->next()[level].load();
+
+				if (marked(succ))
+					curr = ptr(succ); // Skip logically deleted node.
+				else if (curr->data < data)
+				{
+					pred = curr->next();
+					curr = ptr(succ);
+				}
+				else
+					break;
+			}
+		}
+
+		return curr && !(data < curr->data) && !marked(curr->next()[0].load());
+	}
+
+	bool empty() const { return count.load() == 0; }
+	std::size_t size() const { return count.load() < 0 ? 0 : static_cast<std::size_t>(count.load()); }
+
+	// Remove all elements. Not safe against concurrent operations.
+	void clear()
+	{
+		Node* node = ptr(head[0].load());
+
+		while (node)
+		{
+			Node* next = ptr(node->next()[0].load());
+			destroy(node);
+			node = next;
+		}
+
+		for (int i = 0; i < MAX_LEVEL; i++)
+			head[i].store(0);
+		count.store(0);
+	}
+
+	// Smallest element.
+	T lowerBound() const
+	{
+		ebr::guard g;
+		Node* node = first();
+
+		if (!node)
+			throw std::out_of_range("set empty");
+		return node->data;
+	}
+
+	// Largest element.
+	T upperBound() const
+	{
+		ebr::guard g;
+		const link* pred = head;
+		Node* last = nullptr;
+
+		for (int level = MAX_LEVEL - 1; level >= 0; level--)
+		{
+			Node* curr = ptr(pred[level].load());
+
+			while (curr)
+			{
+				std::uintptr_t succ = curr->next()[level].load();
+
+				if (!marked(succ))
+				{
+					last = curr;
+					pred = curr->next();
+				}
+				curr = ptr(succ);
+			}
+		}
+
+		if (!last)
+			throw std::out_of_range("set empty");
+		return last->data;
+	}
+
+	//
+	// Iterators.
+	//
+	class iterator
+	{
+		friend class concurrentSet;
+
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+
+		iterator() : node(nullptr) { }
+
+		bool operator== (const iterator& it) const { return node == it.node; }
+		bool operator!= (const iterator& it) const { return node != it.node; }
+
+		// pre-increment
+		iterator& operator++ ()
+		{
+			node = skip(ptr(node->next()[0].load()));
+			return *this;
+		}
+		// post-increment
+		iterator operator++ (int)
+		{
+			iterator old(*this);
+			++(*this);
+			return old;
+		}
+
+		const T& operator* () const { return node->data; }
+		const T* operator-> () const { return &(node->data); }
+
+	private:
+		explicit iterator(Node* n) : node(n) { }
+
+		ebr::guard g; // Keeps visited nodes alive.
+		Node* node;
+	};
+
+	iterator begin() const
+	{
+		iterator it;
+		it.node = first();
+		return it;
+	}
+	iterator end() const { return iterator(); }
+
+private:
+	link head[MAX_LEVEL];
+	std::atomic<long long> count;
+
+	static Node* create(const T& data, int height)
+	{
+		void* mem = ::operator new(sizeof(Node) + height * sizeof(link));
+		Node* node = new (mem) Node(data, height);
+
+		for (int i = 0; i < height; i++)
+			new (&node->next()[i]) link(0);
+
+		return node;
+	}
+
+	static void destroy(void* p)
+	{
+		Node* node = static_cast<Node*>(p);
+		node->~Node();
+		::operator delete(p);
+	}
+
+	// Drop one token, the last holder hands the node to the epoch domain.
+	static void release(Node* node)
+	{
+		if (node->tokens.fetch_sub(1) == 1)
+			ebr::retire(node, &concurrentSet::destroy);
+	}
+
+	// First unmarked node at or after n on the bottom level.
+	static Node* skip(Node* n)
+	{
+		while (n && marked(n->next()[0].load()))
+			n = ptr(n->next()[0].load());
+		return n;
+	}
+
+	Node* first() const { return skip(ptr(head[0].load())); }
+
+	// Locate predecessors/successors of data on every level, unlinking marked
+	// nodes on the way. Returns true if an unmarked node holding data exists.
+	bool find(const T& data, link** preds, Node** succs)
+	{
+	retry:
+		link* pred = head;
+
+		for (int level = MAX_LEVEL - 1; level >= 0; level--)
+		{
+			Node* curr = ptr(pred[level].load());
+
+			while (curr)
+			{
+				std::uintptr_t succ = curr->next()[level].load();
+
+				if (marked(succ))
+				{
+					std::uintptr_t expected = bits(curr);
+					if (!pred[level].compare_exchange_strong(expected, bits(ptr(succ))))
+						goto retry;
+					curr = ptr(succ);
+				}
+				else if (curr->data < data)
+				{
+					pred = curr->next();
+					curr = ptr(succ);
+				}
+				else
+					break;
+			}
+
+			preds[level] = pred;
+			succs[level] = curr;
+		}
+
+		return succs[0] && !(data < succs[0]->data);
+	}
+
+	// Geometric tower height with p = 1/2.
+	static int randomLevel()
+	{
+		thread_local std::uint64_t state = 0x9E3779B97F4A7C15ull ^ reinterpret_cast<std::uintptr_t>(&state);
+
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+
+		int level = 1;
+		for (std::uint64_t r = state; (r & 1) && level < MAX_LEVEL; r >>= 1)
+			level++;
+		return level;
+	}
+};
+
+#endif
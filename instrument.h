@@ -0,0 +1,179 @@
+/*************************************************************************
+* Title: Tree Instrumentation
+* File: instrument.h
+* Date: 10/18/2026
+*
+* Instrumentation policies for tree<T, Policy>. The tree reports each
+* public operation and the work done inside it to its policy:
+*
+*   begin(op)  // operation op starts. Nested operations (balance adds
+*              // nodes) are attributed to the outermost one.
+*   compare()  // one key comparison.
+*   visit()    // one node visited, depth of the operation grows by one.
+*   allocate() // one node allocated.
+*   rebuild()  // one whole tree rebuild (balance, load).
+*   end()      // operation ends.
+*
+* Policies:
+*
+*   noStats       // default, every hook an empty inline function.
+*   countingStats // per operation counters, read with snapshot().
+*   latencyStats  // per operation latency histograms (latency.h).
+*
+* Notes:
+*  (1) noStats is an empty class the tree derives from, so the default
+*      tree has the same size and code as an uninstrumented one.
+*  (2) Hooks are const, called from const operations such as search, and
+*      countingStats keeps its counters mutable. It is not thread safe,
+*      concurrent readers of an instrumented tree need their own locking.
+*  (3) A policy needs the six hooks above. It may keep any state, the
+*      tree exposes it through policy().
+*************************************************************************
+* Change Log:
+*  10/18/2026: Initial release.
+*  10/18/2026: Iterator positioning counted as OP_BEGIN, apart from
+*              OP_ITERATE steps.
+*************************************************************************/
+#ifndef _INSTRUMENT_H_
+#define _INSTRUMENT_H_
+
+#include <cstdint>     // counters.
+#include <type_traits> // is_empty.
+
+// Instrumented operations. OP_BEGIN positions an iterator (begin, end,
+// rbegin, rend), OP_ITERATE moves one (++, --).
+enum treeOp { OP_ADD, OP_REMOVE, OP_SEARCH, OP_BEGIN, OP_ITERATE, OP_BALANCE, OP_COUNT };
+
+inline const char* opName(treeOp op)
+{
+	static const char* names[OP_COUNT] = { "add", "remove", "search", "begin", "iterate", "balance" };
+	return op < OP_COUNT ? names[op] : "unknown";
+}
+
+// Compiles to nothing.
+struct noStats
+{
+	void begin(treeOp) const { }
+	void compare() const { }
+	void visit() const { }
+	void allocate() const { }
+	void rebuild() const { }
+	void end() const { }
+};
+
+// Counters of one operation type.
+struct opCounters
+{
+	std::uint64_t calls;       // Operations performed.
+	std::uint64_t comparisons; // Key comparisons.
+	std::uint64_t visits;      // Nodes visited, the sum of descent depths.
+	std::uint64_t maxDepth;    // Deepest single operation.
+	std::uint64_t allocations; // Nodes allocated.
+	std::uint64_t rebuilds;    // Whole tree rebuilds.
+};
+
+// Counters of all operation types, a plain copyable value.
+struct statsSnapshot
+{
+	opCounters ops[OP_COUNT];
+
+	opCounters& operator[] (treeOp op) { return ops[op]; }
+	const opCounters& operator[] (treeOp op) const { return ops[op]; }
+
+	// Mean nodes visited per call of op.
+	double meanDepth(treeOp op) const
+	{
+		return ops[op].calls ? static_cast<double>(ops[op].visits) / ops[op].calls : 0.0;
+	}
+};
+
+class countingStats
+{
+public:
+	countingStats() { reset(); }
+
+	void begin(treeOp op) const
+	{
+		if (nesting++)
+			return;
+		current = op;
+		depth = 0;
+		counts.ops[op].calls++;
+	}
+
+	void compare() const { counts.ops[current].comparisons++; }
+
+	void visit() const
+	{
+		counts.ops[current].visits++;
+		depth++;
+	}
+
+	void allocate() const { counts.ops[current].allocations++; }
+	void rebuild() const { counts.ops[current].rebuilds++; }
+
+	void end() const
+	{
+		if (--nesting)
+			return;
+		if (depth > counts.ops[current].maxDepth)
+			counts.ops[current].maxDepth = depth;
+	}
+
+	statsSnapshot snapshot() const { return counts; }
+
+	void reset()
+	{
+		counts = statsSnapshot();
+		current = OP_ADD;
+		depth = 0;
+		nesting = 0;
+	}
+
+private:
+	mutable statsSnapshot counts;
+	mutable treeOp current;
+	mutable std::uint64_t depth;
+	mutable unsigned nesting;
+};
+
+// Scope of one operation, begin on construction, end on destruction.
+template <class Policy>
+class opScope
+{
+public:
+	opScope(const Policy& policy, treeOp op) : policy(policy) { policy.begin(op); }
+	~opScope() { policy.end(); }
+
+	opScope(const opScope&) = delete;
+	opScope& operator= (const opScope&) = delete;
+
+private:
+	const Policy& policy;
+};
+
+// Policy reference held by iterators. Empty for empty policies, so the
+// default tree's iterators stay a single pointer.
+template <class Policy, bool Empty = std::is_empty<Policy>::value>
+class policyRef
+{
+public:
+	policyRef(const Policy* = nullptr) { }
+	const Policy& policyOf() const { static const Policy none; return none; }
+};
+
+template <class Policy>
+class policyRef<Policy, false>
+{
+public:
+	policyRef(const Policy* p = nullptr) : p(p ? p : &none()) { }
+	const Policy& policyOf() const { return *p; }
+
+private:
+	const Policy* p;
+
+	// Target of default constructed iterators.
+	static const Policy& none() { static const Policy unused; return unused; }
+};
+
+#endif
@@ -0,0 +1,383 @@
+/*************************************************************************
+* Title: Latency Histograms
+* File: latency.h
+* Date: 10/18/2026
+*
+* Tail latency of tree operations, as an instrumentation policy:
+*
+*   tree<T, latencyStats> t; // or set<T, latencyStats>.
+*   t.policy().snapshot()    // histograms of all threads, merged.
+*   t.policy().reset()       // clear all histograms.
+*
+* Parts, usable on their own:
+*
+*   latencyClock::now()        // cheap timestamp, in ticks.
+*   latencyClock::nsPerTick()  // tick length, calibrated once.
+*
+*   latencyHistogram h;
+*   h.record(v)                // add a value, O(1).
+*   h.merge(rhs)               // add all values of rhs.
+*   h.count(), min(), max(), mean()
+*   h.percentile(p)            // value at or below which p% of values
+*                              // fall, within the bucket precision.
+*
+*   latencySnapshot s;         // one histogram per treeOp, in ticks.
+*   s.percentileNs(op, p)      // percentile in nanoseconds.
+*   s.write(os)                // JSON, per operation count, min, mean,
+*                              // p50, p90, p99, p99.9 and max in ns.
+*
+* Notes:
+*  (1) Buckets are log-linear as in HdrHistogram: exact below 64, then 32
+*      buckets per power of two, so any value is within 1/32 (about 3%)
+*      of its bucket's upper bound, which percentiles return. Values up
+*      to 2^48 ticks are kept, larger ones share one overflow bucket,
+*      whose percentiles return the largest value recorded.
+*  (2) latencyClock reads the time stamp counter on x86 (rdtsc, not
+*      serializing, fine for operations of tens of ns and more, and
+*      assumes an invariant TSC), std::chrono::steady_clock elsewhere.
+*  (3) Each thread records into its own histograms, found through a
+*      small thread local cache, so concurrent readers of a shared tree
+*      (under a shared lock) do not contend. snapshot() merges them and,
+*      like reset(), must not run while other threads are recording.
+*  (4) Nested operations (balance calls add) are timed as the outermost
+*      one. begin, end, rbegin and rend are all timed as OP_BEGIN.
+*************************************************************************
+* Change Log:
+*  10/18/2026: Initial release.
+*  10/18/2026: Values from 2^48 up get their own overflow bucket instead
+*              of sharing the last bucket below 2^48, whose percentiles
+*              fell short of them.
+*  10/18/2026: end() and rend() timed, as OP_BEGIN, with begin().
+*************************************************************************/
+#ifndef _LATENCY_H_
+#define _LATENCY_H_
+
+#include <atomic>     // policy ids.
+#include <chrono>     // steady clock, calibration.
+#include <cmath>      // ceil.
+#include <cstdint>    // counts, ticks.
+#include <iomanip>    // precision.
+#include <memory>     // thread shards.
+#include <mutex>      // shard list.
+#include <ostream>    // JSON export.
+#include <thread>     // thread ids.
+#include <vector>     // shard list.
+
+#include "instrument.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>    // __rdtsc, _BitScanReverse64.
+#endif
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define LATENCY_RDTSC
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h> // __rdtsc.
+#define LATENCY_RDTSC
+#endif
+
+class latencyClock
+{
+public:
+	static std::uint64_t now()
+	{
+#if defined(LATENCY_RDTSC)
+		return __rdtsc();
+#else
+		return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+	}
+
+	// Measured against steady_clock over a few milliseconds on first call.
+	static double nsPerTick()
+	{
+#if defined(LATENCY_RDTSC)
+		static const double ns = calibrate();
+		return ns;
+#else
+		return 1.0;
+#endif
+	}
+
+private:
+	static double calibrate()
+	{
+		auto t0 = std::chrono::steady_clock::now();
+		std::uint64_t c0 = now();
+		auto t1 = t0;
+
+		while (t1 - t0 < std::chrono::milliseconds(5))
+			t1 = std::chrono::steady_clock::now();
+
+		std::uint64_t c1 = now();
+		double elapsed = std::chrono::duration<double, std::nano>(t1 - t0).count();
+		return c1 > c0 ? elapsed / (c1 - c0) : 1.0;
+	}
+};
+
+class latencyHistogram
+{
+public:
+	latencyHistogram() { clear(); }
+
+	void record(std::uint64_t v)
+	{
+		counts[index(v)]++;
+		total++;
+		sum += v;
+		if (v < lowest)
+			lowest = v;
+		if (v > highest)
+			highest = v;
+	}
+
+	void merge(const latencyHistogram& rhs)
+	{
+		for (int i = 0; i < BUCKETS; i++)
+			counts[i] += rhs.counts[i];
+		total += rhs.total;
+		sum += rhs.sum;
+		if (rhs.lowest < lowest)
+			lowest = rhs.lowest;
+		if (rhs.highest > highest)
+			highest = rhs.highest;
+	}
+
+	void clear()
+	{
+		for (int i = 0; i < BUCKETS; i++)
+			counts[i] = 0;
+		total = sum = highest = 0;
+		lowest = ~std::uint64_t(0);
+	}
+
+	std::uint64_t count() const { return total; }
+	std::uint64_t min() const { return total ? lowest : 0; }
+	std::uint64_t max() const { return highest; }
+	double mean() const { return total ? static_cast<double>(sum) / total : 0.0; }
+
+	// Upper bound of the bucket holding the p-th percentile, 0 <= p <= 100,
+	// clamped to the recorded range. 0 if empty.
+	std::uint64_t percentile(double p) const
+	{
+		if (!total)
+			return 0;
+
+		double want = std::ceil(p / 100.0 * total);
+		std::uint64_t rank = want < 1.0 ? 1 : want >= total ? total : static_cast<std::uint64_t>(want);
+		std::uint64_t seen = 0;
+
+		for (int i = 0; i < BUCKETS; i++)
+			if ((seen += counts[i]) >= rank)
+			{
+				std::uint64_t v = i == BUCKETS - 1 ? highest : upper(i);
+				return v < lowest ? lowest : v > highest ? highest : v;
+			}
+		return highest;
+	}
+
+private:
+	static const int SUB_BITS = 6;               // Exact below 2^SUB_BITS.
+	static const int HALF = 1 << (SUB_BITS - 1); // Buckets per power of two.
+	static const int MAX_BITS = 48;              // Bucketed below 2^MAX_BITS.
+	static const int BUCKETS = (1 << SUB_BITS) + (MAX_BITS - SUB_BITS) * HALF + 1; // Last one overflow.
+
+	std::uint64_t counts[BUCKETS];
+	std::uint64_t total;
+	std::uint64_t sum;
+	std::uint64_t lowest;
+	std::uint64_t highest;
+
+	// Index of the highest set bit, v > 0.
+	static int msb(std::uint64_t v)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		return 63 - __builtin_clzll(v);
+#elif defined(_MSC_VER) && defined(_M_X64)
+		unsigned long n;
+		_BitScanReverse64(&n, v);
+		return static_cast<int>(n);
+#else
+		int n = 0;
+		while (v >>= 1)
+			n++;
+		return n;
+#endif
+	}
+
+	// Values in [2^(SUB_BITS+e-1), 2^(SUB_BITS+e)) share exponent e >= 1,
+	// HALF buckets of width 2^e.
+	static int index(std::uint64_t v)
+	{
+		if (v < (std::uint64_t(1) << SUB_BITS))
+			return static_cast<int>(v);
+
+		int e = msb(v) - SUB_BITS + 1;
+		if (e > MAX_BITS - SUB_BITS)
+			return BUCKETS - 1;
+		return (1 << SUB_BITS) + (e - 1) * HALF + static_cast<int>((v >> e) - HALF);
+	}
+
+	static std::uint64_t upper(int i)
+	{
+		if (i < (1 << SUB_BITS))
+			return static_cast<std::uint64_t>(i);
+
+		int e = (i - (1 << SUB_BITS)) / HALF + 1;
+		std::uint64_t sub = static_cast<std::uint64_t>((i - (1 << SUB_BITS)) % HALF + HALF);
+		return ((sub + 1) << e) - 1;
+	}
+};
+
+// Histograms of all operation types, in ticks, a plain copyable value.
+struct latencySnapshot
+{
+	latencyHistogram ops[OP_COUNT];
+
+	latencyHistogram& operator[] (treeOp op) { return ops[op]; }
+	const latencyHistogram& operator[] (treeOp op) const { return ops[op]; }
+
+	void merge(const latencySnapshot& rhs)
+	{
+		for (int i = 0; i < OP_COUNT; i++)
+			ops[i].merge(rhs.ops[i]);
+	}
+
+	double percentileNs(treeOp op, double p) const { return ops[op].percentile(p) * latencyClock::nsPerTick(); }
+
+	// Operations never performed are left out.
+	void write(std::ostream& os) const
+	{
+		static const double points[] = { 50.0, 90.0, 99.0, 99.9 };
+		static const char* names[] = { "p50", "p90", "p99", "p999" };
+		const double ns = latencyClock::nsPerTick();
+		std::ios_base::fmtflags flags = os.flags();
+		std::streamsize precision = os.precision();
+		bool first = true;
+
+		os << "{" << std::fixed << std::setprecision(1);
+		for (int i = 0; i < OP_COUNT; i++)
+		{
+			const latencyHistogram& h = ops[i];
+			if (!h.count())
+				continue;
+
+			os << (first ? "\n" : ",\n") << "  \"" << opName(static_cast<treeOp>(i)) << "\": { \"count\": " << h.count()
+				<< ", \"min_ns\": " << h.min() * ns << ", \"mean_ns\": " << h.mean() * ns;
+			for (int p = 0; p < 4; p++)
+				os << ", \"" << names[p] << "_ns\": " << h.percentile(points[p]) * ns;
+			os << ", \"max_ns\": " << h.max() * ns << " }";
+			first = false;
+		}
+		os << "\n}\n";
+		os.flags(flags);
+		os.precision(precision);
+	}
+};
+
+class latencyStats
+{
+public:
+	latencyStats() : id(nextId()) { }
+	latencyStats(const latencyStats&) : id(nextId()) { }
+	latencyStats& operator= (const latencyStats&) { return *this; }
+
+	void begin(treeOp op) const
+	{
+		shard& s = local();
+		if (s.nesting++)
+			return;
+		s.current = op;
+		s.start = latencyClock::now();
+	}
+
+	void compare() const { }
+	void visit() const { }
+	void allocate() const { }
+	void rebuild() const { }
+
+	void end() const
+	{
+		shard& s = local();
+		if (--s.nesting)
+			return;
+		std::uint64_t t = latencyClock::now();
+		s.hist[s.current].record(t > s.start ? t - s.start : 0);
+	}
+
+	latencySnapshot snapshot() const
+	{
+		latencySnapshot merged;
+		std::lock_guard<std::mutex> guard(lock);
+
+		for (const std::unique_ptr<shard>& s : shards)
+			merged.merge(s->hist);
+		return merged;
+	}
+
+	void reset()
+	{
+		std::lock_guard<std::mutex> guard(lock);
+
+		for (std::unique_ptr<shard>& s : shards)
+			s->hist = latencySnapshot();
+	}
+
+private:
+	// One thread's histograms and open operation.
+	struct shard
+	{
+		latencySnapshot hist;
+		std::thread::id owner;
+		treeOp current = OP_ADD;
+		unsigned nesting = 0;
+		std::uint64_t start = 0;
+	};
+
+	// Thread local direct mapped cache of policy id to shard. Ids are never
+	// reused, so entries of destroyed policies are never matched again.
+	struct cacheEntry
+	{
+		std::uint64_t id;
+		shard* s;
+	};
+	static const unsigned CACHE_SLOTS = 8;
+
+	mutable std::mutex lock;
+	mutable std::vector<std::unique_ptr<shard>> shards;
+	const std::uint64_t id;
+
+	static std::uint64_t nextId()
+	{
+		static std::atomic<std::uint64_t> ids(1);
+		return ids.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	shard& local() const
+	{
+		static thread_local cacheEntry cache[CACHE_SLOTS] = {};
+		cacheEntry& e = cache[id % CACHE_SLOTS];
+
+		if (e.id != id)
+		{
+			e.id = id;
+			e.s = find(std::this_thread::get_id());
+		}
+		return *e.s;
+	}
+
+	shard* find(std::thread::id self) const
+	{
+		std::lock_guard<std::mutex> guard(lock);
+
+		for (const std::unique_ptr<shard>& s : shards)
+			if (s->owner == self)
+				return s.get();
+
+		shards.emplace_back(new shard());
+		shards.back()->owner = self;
+		return shards.back().get();
+	}
+};
+
+#endif
@@ -0,0 +1,153 @@
+/*************************************************************************
+* Title: Ordered Map
+* File: map.h
+* Date: 10/18/2026
+*
+* Ordered key value map on tree<T>, entries ordered and compared on the
+* key alone:
+*
+*   map<K, V> m;
+*   m[k]                  // value of k, default constructed if absent.
+*   m.at(k)               // value of k, throws out_of_range if absent.
+*   m.try_emplace(k, args...)
+*                         // insert (k, V(args...)) unless k is present,
+*                         // V is not constructed if it is.
+*   m.insert_or_assign(k, v)
+*                         // insert (k, v) or assign v to k's value.
+*   m.insert(entry)       // insert unless entry.first is present.
+*   m.find(k)             // iterator to k's entry, end() if absent.
+*   m.lower_bound(k)      // first entry not less than k.
+*   m.search(k), m.count(k)
+*   m.remove(k)           // remove k's entry, true if it was present.
+*   m.erase(it)           // remove the entry at it, returns the next one.
+*   m.begin(), m.end()    // entries in key order, it->first the key and
+*                         // it->second the value, changed in place.
+*   m.size(), m.empty(), m.clear()
+*   m.balance(), m.enableAutoBalance(knobs), m.stats(), m.policy()
+*                         // as on tree<T>.
+*
+* Notes:
+*  (1) Every operation is a single descent: operator[], try_emplace and
+*      insert_or_assign through tree<T>::emplace_unique, which compares the
+*      key with entries and builds the entry only when the key is absent,
+*      remove through find then erase, which unlinks without descending.
+*      Ascending keys land at the insert finger with no descent at all.
+*  (2) Keys must not be changed through an iterator, values may be.
+*  (3) Values change in place, outside the tree's structural operations,
+*      so the tree's incremental rebalance, which copies entries while they
+*      may still change, is not offered.
+*  (4) remove and erase of an entry with two children move the next
+*      entry into its node, invalidating iterators to that entry too.
+*************************************************************************
+* Change Log:
+*  10/18/2026: Initial release.
+*************************************************************************/
+#ifndef _MAP_H_
+#define _MAP_H_
+
+#include <cstddef>   // size_t.
+#include <stdexcept> // out_of_range.
+#include <utility>   // forward, pair.
+
+#include "tree_with_parent.h"
+
+template <class K, class V, class Policy = noStats>
+class map
+{
+public:
+	struct value_type
+	{
+		K first;
+		V second;
+
+		// Ordered on the key, against entries and against bare keys.
+		bool operator< (const value_type& rhs) const { return first < rhs.first; }
+		bool operator== (const value_type& rhs) const { return first == rhs.first; }
+		friend bool operator< (const value_type& lhs, const K& rhs) { return lhs.first < rhs; }
+		friend bool operator< (const K& lhs, const value_type& rhs) { return lhs < rhs.first; }
+		friend bool operator== (const K& lhs, const value_type& rhs) { return lhs == rhs.first; }
+	};
+
+	typedef tree<value_type, Policy> tree_type;
+	typedef typename tree_type::iterator iterator;
+	typedef typename tree_type::const_iterator const_iterator;
+
+	V& operator[] (const K& key) { return try_emplace(key).first->second; }
+
+	V& at(const K& key) { return valueOf(key); }
+	const V& at(const K& key) const { return valueOf(key); }
+
+	template <class... Args>
+	std::pair<iterator, bool> try_emplace(const K& key, Args&&... args)
+	{
+		return t.emplace_unique(key, [&]() { return value_type{ key, V(std::forward<Args>(args)...) }; });
+	}
+
+	template <class M>
+	std::pair<iterator, bool> insert_or_assign(const K& key, M&& value)
+	{
+		// make() runs only on insert, value is forwarded once either way.
+		std::pair<iterator, bool> at = t.emplace_unique(key, [&]() { return value_type{ key, V(std::forward<M>(value)) }; });
+		if (!at.second)
+			at.first->second = std::forward<M>(value);
+		return at;
+	}
+
+	std::pair<iterator, bool> insert(const value_type& entry) { return t.insert_unique(entry); }
+
+	iterator find(const K& key) { return locate(key); }
+	const_iterator find(const K& key) const { return locate(key); }
+	iterator lower_bound(const K& key) { return t.lower_bound(key); }
+	const_iterator lower_bound(const K& key) const { return t.lower_bound(key); }
+	bool search(const K& key) const { return find(key) != end(); }
+	std::size_t count(const K& key) const { return search(key) ? 1 : 0; }
+
+	bool remove(const K& key)
+	{
+		opScope<Policy> scope(t.policy(), OP_REMOVE);
+		iterator it = find(key);
+		if (it == end())
+			return false;
+		t.erase(it);
+		return true;
+	}
+
+	iterator erase(iterator pos) { return t.erase(pos); }
+
+	iterator begin() { return t.begin(); }
+	iterator end() { return t.end(); }
+	const_iterator begin() const { return t.cbegin(); }
+	const_iterator end() const { return t.cend(); }
+	const_iterator cbegin() const { return t.cbegin(); }
+	const_iterator cend() const { return t.cend(); }
+
+	std::size_t size() const { return t.size(); }
+	bool empty() const { return t.empty(); }
+	void clear() { t.clear(); }
+
+	void balance() { t.balance(); }
+	void enableAutoBalance(const typename tree_type::autoBalanceKnobs& knobs = typename tree_type::autoBalanceKnobs()) { t.enableAutoBalance(knobs); }
+	treeStats stats() const { return t.stats(); }
+	const Policy& policy() const { return t.policy(); }
+	Policy& policy() { return t.policy(); }
+
+private:
+	tree_type t;
+
+	iterator locate(const K& key) const
+	{
+		opScope<Policy> scope(t.policy(), OP_SEARCH);
+		iterator it = t.lower_bound(key);
+		return it != t.end() && key == *it ? it : t.end();
+	}
+
+	V& valueOf(const K& key) const
+	{
+		iterator it = locate(key);
+		if (it == t.end())
+			throw std::out_of_range("map::at: key not found");
+		return it->second;
+	}
+};
+
+#endif
@@ -0,0 +1,611 @@
+/*************************************************************************
+* Title: Memory Mapped Binary Search Tree
+* File: mapped_tree.h
+* Date: 10/18/2026
+*
+* Persistent binary search tree whose nodes live in a memory mapped file.
+* Nodes refer to each other by byte offset from the start of the file
+* instead of by pointer, so a file can be mapped at any address, and
+* opening one is O(1) regardless of its size:
+*
+*   create(path)  // create (or truncate) a tree file, open read/write.
+*   open(path)    // map an existing tree file, read-only by default.
+*   sync()        // flush mapped pages to the file.
+*   close()       // unmap and close the file.
+*   clear()       // deletes tree (file space is reused).
+*   empty()       // returns true if tree is empty.
+*   size()        // returns tree size (number of nodes), O(1).
+*   add(T)        // insert new node. does NOT check if T already exists.
+*   search(T)     // non-recursive search, returns true if T is found.
+*   getHeight()   // returns height of tree.
+*   balance()     // relinks nodes in place as a balanced tree.
+*   begin()/end() // in-order (sorted) bidirectional const iteration.
+*
+* Notes:
+*  (1) T must be trivially copyable, keys are stored as raw bytes in
+*      native byte order. The file header records a byte order tag and
+*      sizeof(T), open() rejects files written with a different layout.
+*  (2) Read-only opens map the file shared, so any number of processes
+*      can search the same file through the page cache at no extra memory
+*      cost. A single writer at a time, readers opened while a writer
+*      is active see an unspecified state until the writer has synced.
+*  (3) The file grows by doubling. Growing remaps the file, which moves
+*      the mapping; iterators hold offsets and stay valid, raw pointers
+*      and references to keys do not.
+*  (4) add() does not rebalance, call balance() after bulk loads.
+*************************************************************************
+* Change Log:
+*  10/18/2026: Initial release.
+*************************************************************************/
+#ifndef _MAPPED_TREE_H_
+#define _MAPPED_TREE_H_
+
+#include <algorithm>   // max.
+#include <cstdint>     // fixed width file fields.
+#include <cstring>     // memcmp, memcpy.
+#include <iterator>    // iterator tags.
+#include <stdexcept>   // runtime error, logic error.
+#include <string>      // file paths.
+#include <type_traits> // is_trivially_copyable.
+#include <utility>     // pair.
+#include "stack.h"     // iterative traversals.
+#include "vector.h"    // node offsets for balancing.
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+template <class T>
+class mappedTree
+{
+	static_assert(std::is_trivially_copyable<T>::value, "mappedTree requires trivially copyable T");
+
+	// File header, at offset 0. Offset 0 therefore never names a node and
+	// doubles as the null link.
+	struct header
+	{
+		char magic[4];
+		std::uint32_t version;
+		std::uint32_t byteOrder;
+		std::uint32_t keySize;
+		std::uint64_t count;
+		std::uint64_t root;
+		std::uint64_t used; // Bytes in use, next node is allocated here.
+	};
+
+	struct node
+	{
+		T data;
+		std::uint64_t left;
+		std::uint64_t right;
+		std::uint64_t parent;
+	};
+
+	static const std::uint64_t NIL = 0;
+	static const std::uint32_t FILE_VERSION = 1;
+	static const std::uint32_t FILE_BYTE_ORDER = 0x01020304;
+	static const char* fileMagic() { return "BSTM"; }
+
+	// Offset of the first node, header rounded up to node alignment.
+	static std::uint64_t firstNode()
+	{
+		return (sizeof(header) + alignof(node) - 1) / alignof(node) * alignof(node);
+	}
+
+public:
+	class iterator;
+	typedef iterator const_iterator;
+
+	mappedTree() : base(nullptr), length(0), writable(false) { }
+	~mappedTree() { close(); }
+
+	mappedTree(const mappedTree<T>&) = delete;
+	const mappedTree<T>& operator= (const mappedTree<T>&) = delete;
+
+	//
+	// File management.
+	//
+
+	// Create or truncate file at path and open it read/write, with room
+	// for capacity nodes before the file first grows.
+	void create(const std::string& path, std::size_t capacity = 1024)
+	{
+		close();
+		writable = true;
+		openFile(path, true);
+
+		try
+		{
+			mapRegion(firstNode() + (capacity ? capacity : 1) * sizeof(node));
+		}
+		catch (...)
+		{
+			close();
+			throw;
+		}
+
+		header* h = hdr();
+		std::memcpy(h->magic, fileMagic(), sizeof(h->magic));
+		h->version = FILE_VERSION;
+		h->byteOrder = FILE_BYTE_ORDER;
+		h->keySize = sizeof(T);
+		h->count = 0;
+		h->root = NIL;
+		h->used = firstNode();
+	}
+
+	// Open an existing tree file. Throws runtime_error if the file is
+	// missing, malformed or was written with a different key layout.
+	void open(const std::string& path, bool readOnly = true)
+	{
+		close();
+		writable = !readOnly;
+		openFile(path, false);
+
+		try
+		{
+			std::uint64_t size = fileSize();
+			if (size < firstNode())
+				throw std::runtime_error("mappedTree::open: truncated header");
+
+			mapRegion(size);
+
+			const header* h = hdr();
+			if (std::memcmp(h->magic, fileMagic(), sizeof(h->magic)) != 0)
+				throw std::runtime_error("mappedTree::open: not a tree file");
+			if (h->version != FILE_VERSION)
+				throw std::runtime_error("mappedTree::open: unsupported version");
+			if (h->byteOrder != FILE_BYTE_ORDER || h->keySize != sizeof(T))
+				throw std::runtime_error("mappedTree::open: incompatible key layout");
+			if (h->used < firstNode() || h->used > length || (h->used - firstNode()) % sizeof(node)
+				|| h->count > (h->used - firstNode()) / sizeof(node) || h->root >= h->used)
+				throw std::runtime_error("mappedTree::open: corrupt header");
+		}
+		catch (...)
+		{
+			close();
+			throw;
+		}
+	}
+
+	// Flush mapped pages to the file, returns once they are written.
+	void sync()
+	{
+		if (!base || !writable)
+			return;
+
+#ifdef _WIN32
+		if (!FlushViewOfFile(base, 0) || !FlushFileBuffers(file))
+			throw std::runtime_error("mappedTree::sync: flush failed");
+#else
+		if (msync(base, length, MS_SYNC) != 0)
+			throw std::runtime_error("mappedTree::sync: msync failed");
+#endif
+	}
+
+	// Unmap and close file. Changes not synced are still written back by
+	// the operating system.
+	void close()
+	{
+		unmapRegion();
+#ifdef _WIN32
+		if (file != INVALID_HANDLE_VALUE)
+			CloseHandle(file);
+		file = INVALID_HANDLE_VALUE;
+#else
+		if (fd >= 0)
+			::close(fd);
+		fd = -1;
+#endif
+	}
+
+	bool isOpen() const { return base != nullptr; }
+
+	//
+	// Basic tree functionality.
+	//
+
+	void clear()
+	{
+		checkWritable();
+		hdr()->root = NIL;
+		hdr()->count = 0;
+		hdr()->used = firstNode();
+	}
+
+	bool empty() const { return size() == 0; }
+	std::size_t size() const { return base ? static_cast<std::size_t>(hdr()->count) : 0; }
+
+	// Add new node to tree, smaller keys go left, equal or larger right.
+	void add(T data)
+	{
+		checkWritable();
+
+		// Allocate first, growing remaps the file.
+		std::uint64_t off = hdr()->used;
+		if (off + sizeof(node) > length)
+			grow(off + sizeof(node));
+		hdr()->used = off + sizeof(node);
+
+		std::uint64_t* link = &hdr()->root;
+		std::uint64_t parent = NIL;
+		while (*link != NIL)
+		{
+			parent = *link;
+			link = data < at(parent)->data ? &at(parent)->left : &at(parent)->right;
+		}
+
+		node* n = at(off);
+		n->data = data;
+		n->left = n->right = NIL;
+		n->parent = parent;
+		*link = off;
+		hdr()->count++;
+	}
+
+	// Non-recursive search.
+	bool search(T data) const
+	{
+		std::uint64_t off = base ? hdr()->root : NIL;
+
+		while (off != NIL)
+		{
+			const node* n = at(off);
+
+			if (data == n->data)
+				return true;
+			off = data < n->data ? n->left : n->right;
+		}
+
+		return false;
+	}
+
+	// Height of tree, iterative.
+	int getHeight() const
+	{
+		if (!base || hdr()->root == NIL)
+			return 0;
+
+		int height = 0;
+		Stack<std::pair<std::uint64_t, int>> stack;
+
+		stack.push(std::make_pair(hdr()->root, 1));
+		while (!stack.empty())
+		{
+			std::pair<std::uint64_t, int> top = stack.pop();
+			const node* n = at(top.first);
+
+			height = std::max(height, top.second);
+			if (n->left != NIL)
+				stack.push(std::make_pair(n->left, top.second + 1));
+			if (n->right != NIL)
+				stack.push(std::make_pair(n->right, top.second + 1));
+		}
+
+		return height;
+	}
+
+	// Relink nodes as a balanced tree, in place. Keys do not move.
+	void balance()
+	{
+		checkWritable();
+
+		Vector<std::uint64_t> offsets;
+		offsets.reserve(size());
+
+		// Iterative in-order walk collecting node offsets.
+		Stack<std::uint64_t> stack;
+		std::uint64_t off = hdr()->root;
+		while (off != NIL || !stack.empty())
+		{
+			while (off != NIL)
+			{
+				stack.push(off);
+				off = at(off)->left;
+			}
+
+			off = stack.pop();
+			offsets.push_back(off);
+			off = at(off)->right;
+		}
+
+		hdr()->root = offsets.size() ? link(&offsets[0], 0, offsets.size(), NIL) : NIL;
+	}
+
+	//
+	// Iterators.
+	//
+
+	iterator begin() const
+	{
+		std::uint64_t off = base ? hdr()->root : NIL;
+
+		if (off != NIL)
+			while (at(off)->left != NIL)
+				off = at(off)->left;
+
+		return iterator(this, off);
+	}
+	iterator end() const { return iterator(this, NIL); }
+	const_iterator cbegin() const { return begin(); }
+	const_iterator cend() const { return end(); }
+
+private:
+	// Mapped file.
+	char* base;
+	std::uint64_t length;
+	bool writable;
+#ifdef _WIN32
+	HANDLE file = INVALID_HANDLE_VALUE;
+	HANDLE mapping = nullptr;
+#else
+	int fd = -1;
+#endif
+
+	header* hdr() { return reinterpret_cast<header*>(base); }
+	const header* hdr() const { return reinterpret_cast<const header*>(base); }
+	node* at(std::uint64_t off) { return reinterpret_cast<node*>(base + off); }
+	const node* at(std::uint64_t off) const { return reinterpret_cast<const node*>(base + off); }
+
+	void checkWritable() const
+	{
+		if (!base)
+			throw std::logic_error("mappedTree: no file open");
+		if (!writable)
+			throw std::logic_error("mappedTree: file opened read-only");
+	}
+
+	// Link sorted node offsets [lo, hi) as a balanced subtree, iteratively
+	// (runs of duplicates degenerate into right leaning chains).
+	std::uint64_t link(const std::uint64_t* offs, std::size_t lo, std::size_t hi, std::uint64_t parent)
+	{
+		struct span { std::size_t lo, hi; std::uint64_t parent; bool right; };
+		std::uint64_t top = NIL;
+		Stack<span> stack;
+
+		stack.push(span{ lo, hi, parent, false });
+		while (!stack.empty())
+		{
+			span r = stack.pop();
+			if (r.lo >= r.hi)
+				continue;
+
+			// Keep duplicates of the middle key in the right subtree (as add).
+			std::size_t half = r.lo + (r.hi - r.lo) / 2;
+			std::size_t mid = std::lower_bound(offs + r.lo, offs + half, offs[half],
+				[this](std::uint64_t a, std::uint64_t b) { return at(a)->data < at(b)->data; }) - offs;
+
+			node* n = at(offs[mid]);
+			n->parent = r.parent;
+			n->left = n->right = NIL;
+			if (r.parent == NIL)
+				top = offs[mid];
+			else if (r.right)
+				at(r.parent)->right = offs[mid];
+			else
+				at(r.parent)->left = offs[mid];
+
+			stack.push(span{ r.lo, mid, offs[mid], false });
+			stack.push(span{ mid + 1, r.hi, offs[mid], true });
+		}
+
+		return top;
+	}
+
+	// In-order successor of node at off, NIL after the maximum.
+	std::uint64_t successor(std::uint64_t off) const
+	{
+		if (at(off)->right != NIL)
+		{
+			off = at(off)->right;
+			while (at(off)->left != NIL)
+				off = at(off)->left;
+			return off;
+		}
+
+		std::uint64_t parent = at(off)->parent;
+		while (parent != NIL && off == at(parent)->right)
+		{
+			off = parent;
+			parent = at(parent)->parent;
+		}
+
+		return parent;
+	}
+
+	// In-order predecessor of node at off, the maximum for NIL (end).
+	std::uint64_t predecessor(std::uint64_t off) const
+	{
+		if (off == NIL)
+		{
+			off = hdr()->root;
+			if (off != NIL)
+				while (at(off)->right != NIL)
+					off = at(off)->right;
+			return off;
+		}
+
+		if (at(off)->left != NIL)
+		{
+			off = at(off)->left;
+			while (at(off)->right != NIL)
+				off = at(off)->right;
+			return off;
+		}
+
+		std::uint64_t parent = at(off)->parent;
+		while (parent != NIL && off == at(parent)->left)
+		{
+			off = parent;
+			parent = at(parent)->parent;
+		}
+
+		return parent;
+	}
+
+	// Grow file to hold at least need bytes, doubling.
+	void grow(std::uint64_t need)
+	{
+		std::uint64_t size = length * 2;
+		if (size < need)
+			size = need;
+
+		unmapRegion();
+		mapRegion(size);
+	}
+
+	//
+	// Platform specific file and mapping handling.
+	//
+
+#ifdef _WIN32
+	void openFile(const std::string& path, bool truncate)
+	{
+		file = CreateFileA(path.c_str(), writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ,
+			FILE_SHARE_READ, nullptr, truncate ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			throw std::runtime_error("mappedTree: cannot open " + path);
+	}
+
+	std::uint64_t fileSize() const
+	{
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size))
+			throw std::runtime_error("mappedTree: cannot stat file");
+		return static_cast<std::uint64_t>(size.QuadPart);
+	}
+
+	// Map size bytes of the file. Writable mappings extend the file.
+	void mapRegion(std::uint64_t size)
+	{
+		mapping = CreateFileMappingA(file, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY,
+			static_cast<DWORD>(size >> 32), static_cast<DWORD>(size), nullptr);
+		if (!mapping)
+			throw std::runtime_error("mappedTree: CreateFileMapping failed");
+
+		base = static_cast<char*>(MapViewOfFile(mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0));
+		if (!base)
+		{
+			CloseHandle(mapping);
+			mapping = nullptr;
+			throw std::runtime_error("mappedTree: MapViewOfFile failed");
+		}
+		length = size;
+	}
+
+	void unmapRegion()
+	{
+		if (base)
+			UnmapViewOfFile(base);
+		if (mapping)
+			CloseHandle(mapping);
+		base = nullptr;
+		mapping = nullptr;
+		length = 0;
+	}
+#else
+	void openFile(const std::string& path, bool truncate)
+	{
+		int flags = writable ? O_RDWR : O_RDONLY;
+		if (truncate)
+			flags |= O_CREAT | O_TRUNC;
+
+		fd = ::open(path.c_str(), flags, 0644);
+		if (fd < 0)
+			throw std::runtime_error("mappedTree: cannot open " + path);
+	}
+
+	std::uint64_t fileSize() const
+	{
+		struct stat st;
+		if (fstat(fd, &st) != 0)
+			throw std::runtime_error("mappedTree: cannot stat file");
+		return static_cast<std::uint64_t>(st.st_size);
+	}
+
+	// Map size bytes of the file. Writable mappings extend the file.
+	void mapRegion(std::uint64_t size)
+	{
+		if (writable && fileSize() < size && ftruncate(fd, static_cast<off_t>(size)) != 0)
+			throw std::runtime_error("mappedTree: cannot extend file");
+
+		void* p = mmap(nullptr, static_cast<std::size_t>(size), writable ? PROT_READ | PROT_WRITE : PROT_READ,
+			MAP_SHARED, fd, 0);
+		if (p == MAP_FAILED)
+			throw std::runtime_error("mappedTree: mmap failed");
+
+		base = static_cast<char*>(p);
+		length = size;
+	}
+
+	void unmapRegion()
+	{
+		if (base)
+			munmap(base, static_cast<std::size_t>(length));
+		base = nullptr;
+		length = 0;
+	}
+#endif
+};
+
+// Bidirectional iterator over keys in sorted order. Holds the tree and a
+// node offset, so it survives the tree growing its file.
+template <class T>
+class mappedTree<T>::iterator
+{
+	friend class mappedTree<T>;
+
+public:
+	typedef std::bidirectional_iterator_tag iterator_category;
+	typedef T value_type;
+	typedef std::ptrdiff_t difference_type;
+	typedef const T* pointer;
+	typedef const T& reference;
+
+	iterator() : owner(nullptr), off(NIL) { }
+
+	reference operator*() const { return owner->at(off)->data; }
+	pointer operator->() const { return &owner->at(off)->data; }
+
+	iterator& operator++()
+	{
+		off = owner->successor(off);
+		return *this;
+	}
+	iterator operator++(int)
+	{
+		iterator old = *this;
+		++*this;
+		return old;
+	}
+	iterator& operator--()
+	{
+		off = owner->predecessor(off);
+		return *this;
+	}
+	iterator operator--(int)
+	{
+		iterator old = *this;
+		--*this;
+		return old;
+	}
+
+	bool operator== (const iterator& rhs) const { return owner == rhs.owner && off == rhs.off; }
+	bool operator!= (const iterator& rhs) const { return !(*this == rhs); }
+
+private:
+	iterator(const mappedTree<T>* t, std::uint64_t o) : owner(t), off(o) { }
+
+	const mappedTree<T>* owner;
+	std::uint64_t off;
+};
+
+#endif
@@ -0,0 +1,187 @@
+/*************************************************************************
+* Title: Counted Multiset
+* File: multiset.h
+* Date: 10/18/2026
+*
+* Multiset on tree<T> keeping one node per distinct key with a count of
+* its copies, so repeated keys neither allocate nor deepen the tree:
+*
+*   multiset<T> m;
+*   m.add(T, n)       // add n copies (default 1), O(log n), allocates only
+*                     // for a new key.
+*   m.remove(T, n)    // remove up to n copies (default 1), returns the
+*                     // number removed. The node goes with the last one.
+*   m.count(T)        // copies of T.
+*   m.search(T)       // true if T is present.
+*   m.size()          // copies of all keys.
+*   m.distinct()      // distinct keys, the tree's node count.
+*   m.begin(), m.end()
+*                     // every copy in order, duplicates expanded.
+*   m.distinct_begin(), m.distinct_end()
+*                     // one entry per key in order, duplicates collapsed
+*                     // into entry.key and entry.count.
+*   m.balance(), m.enableAutoBalance(knobs), m.stats(), m.policy()
+*                     // as on tree<T>.
+*
+* Notes:
+*  (1) add is tree<T>::insert_unique, a single descent, or none when the
+*      key lands at the insert finger (ascending input). remove descends
+*      once, the last copy's node then unlinked in place (tree<T>::erase).
+*  (2) Counts change in place, not through the tree's structural
+*      operations, so the tree's incremental rebalance, which copies keys
+*      while they may still change, is not offered.
+*************************************************************************
+* Change Log:
+*  10/18/2026: Initial release.
+*************************************************************************/
+#ifndef _MULTISET_H_
+#define _MULTISET_H_
+
+#include <cstddef>  // size_t.
+#include <iterator> // bidirectional_iterator_tag.
+
+#include "tree_with_parent.h"
+
+template <class T, class Policy = noStats>
+class multiset
+{
+public:
+	// A distinct key and its copies. Ordered and compared on key alone.
+	struct entry
+	{
+		T key;
+		std::size_t count;
+
+		bool operator< (const entry& rhs) const { return key < rhs.key; }
+		bool operator== (const entry& rhs) const { return key == rhs.key; }
+	};
+
+	typedef tree<entry, Policy> tree_type;
+	typedef typename tree_type::const_iterator distinct_iterator;
+	class const_iterator;
+
+	multiset() : total(0) { }
+
+	void add(const T& key, std::size_t n = 1)
+	{
+		if (!n)
+			return;
+
+		std::pair<typename tree_type::iterator, bool> at = t.insert_unique(entry{ key, n });
+		if (!at.second)
+			at.first->count += n;
+		total += n;
+	}
+
+	std::size_t remove(const T& key, std::size_t n = 1)
+	{
+		opScope<Policy> scope(t.policy(), OP_REMOVE);
+		typename tree_type::iterator at = find(key);
+
+		if (at == t.end() || !n)
+			return 0;
+		if (at->count > n)
+			at->count -= n;
+		else
+		{
+			n = at->count;
+			t.erase(at);
+		}
+		total -= n;
+		return n;
+	}
+
+	std::size_t count(const T& key) const
+	{
+		typename tree_type::iterator at = find(key);
+		return at == t.end() ? 0 : at->count;
+	}
+
+	bool search(const T& key) const { return count(key) != 0; }
+	void clear() { t.clear(); total = 0; }
+	bool empty() const { return t.empty(); }
+	std::size_t size() const { return total; }
+	std::size_t distinct() const { return t.size(); }
+
+	const_iterator begin() const { return const_iterator(t.cbegin(), 0); }
+	const_iterator end() const { return const_iterator(t.cend(), 0); }
+	distinct_iterator distinct_begin() const { return t.cbegin(); }
+	distinct_iterator distinct_end() const { return t.cend(); }
+
+	void balance() { t.balance(); }
+	void enableAutoBalance(const typename tree_type::autoBalanceKnobs& knobs = typename tree_type::autoBalanceKnobs()) { t.enableAutoBalance(knobs); }
+	treeStats stats() const { return t.stats(); }
+	const Policy& policy() const { return t.policy(); }
+	Policy& policy() { return t.policy(); }
+
+private:
+	tree_type t;
+	std::size_t total;
+
+	// The key's entry, end() if absent.
+	typename tree_type::iterator find(const T& key) const
+	{
+		typename tree_type::iterator at = t.lower_bound(entry{ key, 0 });
+		return at != t.end() && at->key == key ? at : t.end();
+	}
+};
+
+// Every copy of every key in order, an entry's key repeated count times.
+template <class T, class Policy>
+class multiset<T, Policy>::const_iterator
+{
+public:
+	typedef std::bidirectional_iterator_tag iterator_category;
+
+	const_iterator() : copy(0) { }
+	const_iterator(distinct_iterator at, std::size_t copy) : at(at), copy(copy) { }
+
+	bool operator== (const const_iterator& it) const { return at == it.at && copy == it.copy; }
+	bool operator!= (const const_iterator& it) const { return !(*this == it); }
+
+	const_iterator& operator++ ()
+	{
+		if (++copy == at->count)
+		{
+			++at;
+			copy = 0;
+		}
+		return *this;
+	}
+	const_iterator operator++ (int)
+	{
+		const_iterator old(*this);
+		++(*this);
+		return old;
+	}
+
+	const_iterator& operator-- ()
+	{
+		if (copy)
+			--copy;
+		else
+		{
+			--at;
+			copy = at->count - 1;
+		}
+		return *this;
+	}
+	const_iterator operator-- (int)
+	{
+		const_iterator old(*this);
+		--(*this);
+		return old;
+	}
+
+	const T& operator* () const { return at->key; }
+	const T* operator-> () const { return &at->key; }
+
+	// The entry holding this copy.
+	const entry& group() const { return *at; }
+
+private:
+	distinct_iterator at;
+	std::size_t copy;
+};
+
+#endif
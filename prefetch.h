@@ -0,0 +1,35 @@
+/*************************************************************************
+* Title: Prefetch
+* File: prefetch.h
+* Date: 10/18/2026
+*
+* Portable software prefetch hint:
+*
+*   prefetch(p) // start loading the cache line holding p, for reading.
+*
+* Notes:
+*  (1) A hint only, never faults, a null or stale pointer is harmless.
+*      Compiles to nothing where the compiler has no prefetch intrinsic.
+*************************************************************************
+* Change Log:
+*  10/18/2026: Initial release.
+*************************************************************************/
+#ifndef _PREFETCH_H_
+#define _PREFETCH_H_
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h> // _mm_prefetch.
+#endif
+
+inline void prefetch(const void* p)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	__builtin_prefetch(p, 0, 3);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	_mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#else
+	(void)p;
+#endif
+}
+
+#endif
@@ -22,11 +22,12 @@
 *  10/21/2018: Initial release. JME
 *  10/26/2018: Added size template parameter.  JME
 *  10/26/2018: Added smart pointer.  JME
+*  10/18/2026: Include stdexcept for out_of_range.
 *************************************************************************/
 #ifndef _QUEUE_H_
 #define _QUEUE_H_
 
-#include <exception> // out of range
+#include <stdexcept> // out of range
 #include <memory>    // smart pointer
 
 // Default size of queue array if not specified during instantiation.
@@ -3,13 +3,13 @@
 
 #include "tree_with_parent.h"
 
-template <class T>
-struct set : public tree<T>
+template <class T, class Policy = noStats>
+struct set : public tree<T, Policy>
 {
-	using base_iterator = typename tree<T>::iterator;
+	using base = tree<T, Policy>;
+	using base_iterator = typename base::iterator;
 
-	template <typename T>
-	void set_union(const set<T>& s, set<T>& result)
+	void set_union(const set& s, set& result)
 	{
 		for (base_iterator it = this->begin(); it != this->end(); ++it)
 			result.insert(*it);
@@ -21,8 +21,7 @@ struct set : public tree<T>
 			result.insert(*it);
 	}
 
-	template <typename T>
-	void set_intersection(const set<T>& s, set<T>& result)
+	void set_intersection(const set& s, set& result)
 	{
 		if (this == &s)
 		{
@@ -49,8 +48,7 @@ struct set : public tree<T>
 		}
 	}
 
-	template <typename T>
-	void set_symmetric_difference(const set<T>& s, set<T>& result)
+	void set_symmetric_difference(const set& s, set& result)
 	{
 		if (this != &s)
 		{
@@ -81,8 +79,7 @@ struct set : public tree<T>
 		}
 	}
 
-	template <typename T>
-	void set_difference(const set<T>& s, set<T>& result)
+	void set_difference(const set& s, set& result)
 	{
 		if (this != &s)
 		{
@@ -109,11 +106,11 @@ struct set : public tree<T>
 		}
 	}
 
-	// Reject identical data.
-	void insert(const T data) { if (!tree<T>::search(data)) tree<T>::add(data); }
+	// Reject identical data, in a single descent.
+	void insert(const T data) { base::insert_unique(data); }
 
-	T lowerBound() const { return *tree<T>::begin(); }
-	T upperBound() const { return *tree<T>::rbegin(); }
+	T lowerBound() const { return *base::begin(); }
+	T upperBound() const { return *base::rbegin(); }
 };
 
 #endif
@@ -0,0 +1,296 @@
+/*************************************************************************
+* Title: Shared Tree
+* File: shared_tree.h
+* Date: 10/18/2026
+*
+* A tree<T> shared by reader and writer threads, rebalanced on a
+* background thread while both carry on:
+*
+*   sharedTree<T> s;
+*   s.add(T), s.remove(T), s.clear()
+*                      // writers, one at a time.
+*   s.read()           // a view, const access to the current tree until
+*                      // the view is destroyed.
+*   s.search(T), s.size()
+*                      // through a short lived view.
+*   s.rebalanceAsync() // start rebalancing on a background thread, false
+*                      // if it already is.
+*   s.wait()           // wait for it, rethrowing what it threw.
+*   s.rebalancing()    // true while the background thread runs.
+*   s.versions()       // balanced trees published so far.
+*
+* Notes:
+*  (1) The tree lives in a version. The background thread copies the
+*      current version's keys in order (makeArray), builds a balanced
+*      tree from them in a new version (buildTree) holding no lock,
+*      replays the adds, removes and clears logged meanwhile, then
+*      publishes it with an atomic store.
+*  (2) Views taken before the publish keep reading the old version until
+*      released. The background thread then frees the old tree, so
+*      readers never pay for it. Views taken after see the new version.
+*  (3) Writers lock the current version exclusively, waiting for its
+*      views, so a view held by a writer's thread deadlocks it. Writers
+*      also pause while the keys are copied (a linear scan, no
+*      allocation) and for the last round of the replay, long replays
+*      running in rounds outside the lock first.
+*  (4) Views give the tree's const operations to any number of threads.
+*      Each version has a Policy of its own, which must be thread safe
+*      (noStats, latencyStats).
+*************************************************************************
+* Change Log:
+*  10/18/2026: Initial release.
+*************************************************************************/
+#ifndef _SHARED_TREE_H_
+#define _SHARED_TREE_H_
+
+#include <atomic>       // state read by any thread.
+#include <cstdint>      // version count.
+#include <exception>    // background failure.
+#include <memory>       // versions, atomic_load, atomic_store.
+#include <mutex>        // writer lock.
+#include <shared_mutex> // version locks.
+#include <thread>       // background rebalancing.
+#include <utility>      // move.
+#include <vector>       // change log.
+
+#include "tree_with_parent.h"
+
+template <class T, class Policy = noStats>
+class sharedTree
+{
+	struct version;
+
+public:
+	typedef tree<T, Policy> tree_type;
+
+	// Const access to one version's tree, holding a shared lock on it.
+	class view
+	{
+	public:
+		view(view&& rhs) : v(std::move(rhs.v)), lock(std::move(rhs.lock)) { }
+
+		const tree_type& operator* () const { return v->t; }
+		const tree_type* operator-> () const { return &v->t; }
+
+	private:
+		friend class sharedTree;
+
+		// Declared first, so the lock is released before the version.
+		std::shared_ptr<version> v;
+		std::shared_lock<std::shared_timed_mutex> lock;
+
+		view(std::shared_ptr<version> v, std::shared_lock<std::shared_timed_mutex> lock) : v(std::move(v)), lock(std::move(lock)) { }
+	};
+
+	sharedTree() : current(std::make_shared<version>()) { }
+	~sharedTree()
+	{
+		if (worker.joinable())
+			worker.join();
+	}
+
+	sharedTree(const sharedTree&) = delete;
+	sharedTree& operator= (const sharedTree&) = delete;
+
+	//
+	// Readers.
+	//
+
+	view read() const
+	{
+		while (true)
+		{
+			std::shared_ptr<version> v = std::atomic_load(&current);
+			std::shared_lock<std::shared_timed_mutex> lock(v->lock);
+
+			// Replaced between the load and the lock, its tree may be gone.
+			if (std::atomic_load(&current) == v)
+				return view(std::move(v), std::move(lock));
+		}
+	}
+
+	bool search(T data) const { return read()->search(data); }
+	std::size_t size() const { return read()->size(); }
+
+	//
+	// Writers.
+	//
+
+	void add(T data)
+	{
+		std::lock_guard<std::mutex> guard(writeLock);
+		std::unique_lock<std::shared_timed_mutex> lock(current->lock);
+
+		current->t.add(data);
+		log(data, CHANGE_ADD);
+	}
+
+	bool remove(T data)
+	{
+		std::lock_guard<std::mutex> guard(writeLock);
+		std::unique_lock<std::shared_timed_mutex> lock(current->lock);
+
+		bool removed = current->t.remove(data);
+		if (removed)
+			log(data, CHANGE_REMOVE);
+		return removed;
+	}
+
+	void clear()
+	{
+		std::lock_guard<std::mutex> guard(writeLock);
+		std::unique_lock<std::shared_timed_mutex> lock(current->lock);
+
+		current->t.clear();
+		log(T(), CHANGE_CLEAR);
+	}
+
+	//
+	// Background rebalancing.
+	//
+
+	bool rebalanceAsync()
+	{
+		std::lock_guard<std::mutex> guard(controlLock);
+
+		if (running)
+			return false;
+		if (worker.joinable())
+			worker.join();
+
+		failure = nullptr;
+		running = true;
+		worker = std::thread(&sharedTree::rebalance, this);
+		return true;
+	}
+
+	void wait()
+	{
+		std::lock_guard<std::mutex> guard(controlLock);
+
+		if (worker.joinable())
+			worker.join();
+		if (failure)
+		{
+			std::exception_ptr e = failure;
+			failure = nullptr;
+			std::rethrow_exception(e);
+		}
+	}
+
+	bool rebalancing() const { return running; }
+	std::uint64_t versions() const { return published; }
+
+private:
+	// Replays done outside the writer lock before the final one, and the
+	// log length short enough to replay under it.
+	static const int REPLAY_ROUNDS = 4;
+	static const std::size_t REPLAY_LOCKED = 256;
+
+	enum changeOp { CHANGE_ADD, CHANGE_REMOVE, CHANGE_CLEAR };
+
+	struct change
+	{
+		T key;
+		changeOp op;
+	};
+
+	struct version
+	{
+		tree_type t;
+		std::shared_timed_mutex lock;
+	};
+
+	// Replaced only under writeLock, with atomic_store as readers load it
+	// at any time.
+	std::shared_ptr<version> current;
+
+	// Serializes writers, the change log and publishing.
+	std::mutex writeLock;
+	bool logging = false;
+	std::vector<change> changes;
+
+	std::mutex controlLock;
+	std::thread worker;
+	std::atomic<bool> running{ false };
+	std::atomic<std::uint64_t> published{ 0 };
+	std::exception_ptr failure;
+
+	void log(const T& key, changeOp op)
+	{
+		if (logging)
+			changes.push_back(change{ key, op });
+	}
+
+	static void replay(tree_type& t, const std::vector<change>& log)
+	{
+		for (const change& c : log)
+		{
+			if (c.op == CHANGE_ADD)
+				t.add(c.key);
+			else if (c.op == CHANGE_REMOVE)
+				t.remove(c.key);
+			else
+				t.clear();
+		}
+	}
+
+	// Background thread.
+	void rebalance()
+	{
+		try
+		{
+			std::shared_ptr<version> next = std::make_shared<version>(), old;
+			Vector<T> keys;
+
+			// Writers wait for the copy, readers carry on.
+			{
+				std::lock_guard<std::mutex> guard(writeLock);
+				keys.reserve(current->t.size());
+				current->t.makeArray(current->t.root, keys);
+				logging = true;
+			}
+
+			next->t.policy().rebuild();
+			next->t.buildTree(keys, 0, static_cast<int>(keys.size()) - 1);
+			keys.clear();
+
+			// Catch up outside the lock while the log is long, then replay
+			// the rest and publish under it.
+			std::vector<change> batch;
+			for (int round = 0; ; round++)
+			{
+				std::unique_lock<std::mutex> guard(writeLock);
+				batch.swap(changes);
+
+				if (batch.size() <= REPLAY_LOCKED || round == REPLAY_ROUNDS)
+				{
+					replay(next->t, batch);
+					old = current;
+					std::atomic_store(&current, next);
+					logging = false;
+					published++;
+					break;
+				}
+
+				guard.unlock();
+				replay(next->t, batch);
+				batch.clear();
+			}
+
+			// Free the old tree here once its views are released.
+			std::unique_lock<std::shared_timed_mutex> drain(old->lock);
+			old->t.clear();
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> guard(writeLock);
+			logging = false;
+			changes.clear();
+			failure = std::current_exception();
+		}
+		running = false;
+	}
+};
+
+#endif
@@ -0,0 +1,404 @@
+/*************************************************************************
+* Title: SIMD Search
+* File: simd_search.h
+* Date: 10/18/2026
+*
+* Vectorized search of small sorted key arrays, as found in wide tree
+* nodes:
+*
+*   simd::lowerBound(first, last, key) // first element not less than key.
+*   simd::upperBound(first, last, key) // first element greater than key.
+*   simd::findByte16(keys, n, b)       // index of b in a 16 byte node key
+*                                      // array holding n keys, -1 if absent.
+*   simd::lowerBoundByte16(keys, n, b) // first of n sorted node key bytes
+*                                      // not less than b.
+*
+* Notes:
+*  (1) Ranges of up to LINEAR_MAX keys are compared against the key all
+*      at once, a vector compare and mask count per 4 to 32 keys instead
+*      of a branch per key. Longer ranges are first narrowed to that size
+*      by binary search.
+*  (2) Signed and unsigned integers of 1, 2, 4 and 8 bytes, float and
+*      double are vectorized, other types use the scalar loop. Floating
+*      keys must not be NaN.
+*  (3) The instruction set is chosen at compile time: AVX2 when the
+*      compiler targets it (-mavx2, /arch:AVX2), otherwise SSE2 (always
+*      present on x86-64), otherwise scalar. 8 byte integers need AVX2.
+*      Define SIMD_SEARCH_SCALAR to force the scalar code.
+*************************************************************************
+* Change Log:
+*  10/18/2026: Initial release.
+*************************************************************************/
+#ifndef _SIMD_SEARCH_H_
+#define _SIMD_SEARCH_H_
+
+#include <cstddef>     // size_t.
+#include <cstdint>     // fixed width bias constants.
+#include <type_traits> // key classification.
+
+#if !defined(SIMD_SEARCH_SCALAR)
+#if defined(__AVX2__)
+#define SIMD_SEARCH_AVX2
+#define SIMD_SEARCH_SSE2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_SEARCH_SSE2
+#endif
+#endif
+
+#if defined(SIMD_SEARCH_AVX2)
+#include <immintrin.h>
+#elif defined(SIMD_SEARCH_SSE2)
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace simd
+{
+	// Ranges up to this many keys are scanned, longer ones are bisected
+	// down to it first.
+	const std::size_t LINEAR_MAX = 32;
+
+	inline unsigned popcount(unsigned x)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		return static_cast<unsigned>(__builtin_popcount(x));
+#else
+		x = x - ((x >> 1) & 0x55555555u);
+		x = (x & 0x33333333u) + ((x >> 2) & 0x33333333u);
+		return (((x + (x >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24;
+#endif
+	}
+
+	// Index of the lowest set bit, x != 0.
+	inline unsigned lowestBit(unsigned x)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		return static_cast<unsigned>(__builtin_ctz(x));
+#elif defined(_MSC_VER)
+		unsigned long i;
+		_BitScanForward(&i, x);
+		return static_cast<unsigned>(i);
+#else
+		unsigned i = 0;
+		while (!(x & 1))
+		{
+			x >>= 1;
+			i++;
+		}
+		return i;
+#endif
+	}
+
+	enum keyKind { OTHER, SIGNED, UNSIGNED, FLOATING };
+
+	template <class T>
+	struct kindOf : std::integral_constant<int,
+		std::is_floating_point<T>::value ? FLOATING
+		: !std::is_integral<T>::value || std::is_same<T, bool>::value ? OTHER
+		: std::is_signed<T>::value ? SIGNED : UNSIGNED> { };
+
+	// Count keys of p[0, n) less than key, and greater than key. Scalar,
+	// specialized below per key kind and width.
+	template <class T, int Kind = kindOf<T>::value, std::size_t Size = sizeof(T)>
+	struct counter
+	{
+		static std::size_t less(const T* p, std::size_t n, const T& key)
+		{
+			std::size_t c = 0;
+			for (std::size_t i = 0; i < n; i++)
+				c += p[i] < key;
+			return c;
+		}
+
+		static std::size_t greater(const T* p, std::size_t n, const T& key)
+		{
+			std::size_t c = 0;
+			for (std::size_t i = 0; i < n; i++)
+				c += key < p[i];
+			return c;
+		}
+	};
+
+#if defined(SIMD_SEARCH_SSE2)
+	// 1 byte integers, 16 per compare. Unsigned keys are biased into the
+	// signed range, compares being signed only.
+	template <class T, int Bias>
+	struct counter8
+	{
+		static std::size_t count(const T* p, std::size_t n, const T& key, bool less)
+		{
+			const __m128i bias = _mm_set1_epi8(static_cast<char>(Bias));
+			const __m128i k = _mm_xor_si128(_mm_set1_epi8(static_cast<char>(key)), bias);
+			std::size_t c = 0, i = 0;
+
+			for (; i + 16 <= n; i += 16)
+			{
+				__m128i v = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)), bias);
+				c += popcount(static_cast<unsigned>(_mm_movemask_epi8(less ? _mm_cmpgt_epi8(k, v) : _mm_cmpgt_epi8(v, k))));
+			}
+			for (; i < n; i++)
+				c += less ? p[i] < key : key < p[i];
+			return c;
+		}
+
+		static std::size_t less(const T* p, std::size_t n, const T& key) { return count(p, n, key, true); }
+		static std::size_t greater(const T* p, std::size_t n, const T& key) { return count(p, n, key, false); }
+	};
+
+	template <class T> struct counter<T, SIGNED, 1> : counter8<T, 0> { };
+	template <class T> struct counter<T, UNSIGNED, 1> : counter8<T, 0x80> { };
+
+	// 2 byte integers, 8 per compare, 2 mask bits per key.
+	template <class T, int Bias>
+	struct counter16
+	{
+		static std::size_t count(const T* p, std::size_t n, const T& key, bool less)
+		{
+			const __m128i bias = _mm_set1_epi16(static_cast<short>(Bias));
+			const __m128i k = _mm_xor_si128(_mm_set1_epi16(static_cast<short>(key)), bias);
+			std::size_t c = 0, i = 0;
+
+			for (; i + 8 <= n; i += 8)
+			{
+				__m128i v = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)), bias);
+				c += popcount(static_cast<unsigned>(_mm_movemask_epi8(less ? _mm_cmpgt_epi16(k, v) : _mm_cmpgt_epi16(v, k)))) / 2;
+			}
+			for (; i < n; i++)
+				c += less ? p[i] < key : key < p[i];
+			return c;
+		}
+
+		static std::size_t less(const T* p, std::size_t n, const T& key) { return count(p, n, key, true); }
+		static std::size_t greater(const T* p, std::size_t n, const T& key) { return count(p, n, key, false); }
+	};
+
+	template <class T> struct counter<T, SIGNED, 2> : counter16<T, 0> { };
+	template <class T> struct counter<T, UNSIGNED, 2> : counter16<T, 0x8000> { };
+
+	// 4 byte integers, 8 per compare with AVX2, else 4.
+	template <class T, std::uint32_t Bias>
+	struct counter32
+	{
+		static std::size_t count(const T* p, std::size_t n, const T& key, bool less)
+		{
+			const int b = static_cast<int>(Bias);
+			const int kb = static_cast<int>(static_cast<std::uint32_t>(key) ^ Bias);
+			std::size_t c = 0, i = 0;
+
+#if defined(SIMD_SEARCH_AVX2)
+			const __m256i bias8 = _mm256_set1_epi32(b);
+			const __m256i k8 = _mm256_set1_epi32(kb);
+			for (; i + 8 <= n; i += 8)
+			{
+				__m256i v = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i)), bias8);
+				__m256i m = less ? _mm256_cmpgt_epi32(k8, v) : _mm256_cmpgt_epi32(v, k8);
+				c += popcount(static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(m))));
+			}
+#endif
+			const __m128i bias4 = _mm_set1_epi32(b);
+			const __m128i k4 = _mm_set1_epi32(kb);
+			for (; i + 4 <= n; i += 4)
+			{
+				__m128i v = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)), bias4);
+				__m128i m = less ? _mm_cmpgt_epi32(k4, v) : _mm_cmpgt_epi32(v, k4);
+				c += popcount(static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(m))));
+			}
+			for (; i < n; i++)
+				c += less ? p[i] < key : key < p[i];
+			return c;
+		}
+
+		static std::size_t less(const T* p, std::size_t n, const T& key) { return count(p, n, key, true); }
+		static std::size_t greater(const T* p, std::size_t n, const T& key) { return count(p, n, key, false); }
+	};
+
+	template <class T> struct counter<T, SIGNED, 4> : counter32<T, 0> { };
+	template <class T> struct counter<T, UNSIGNED, 4> : counter32<T, 0x80000000u> { };
+
+#if defined(SIMD_SEARCH_AVX2)
+	// 8 byte integers, 4 per compare (64-bit compares need AVX2 here).
+	template <class T, std::uint64_t Bias>
+	struct counter64
+	{
+		static std::size_t count(const T* p, std::size_t n, const T& key, bool less)
+		{
+			const __m256i bias = _mm256_set1_epi64x(static_cast<long long>(Bias));
+			const __m256i k = _mm256_set1_epi64x(static_cast<long long>(static_cast<std::uint64_t>(key) ^ Bias));
+			std::size_t c = 0, i = 0;
+
+			for (; i + 4 <= n; i += 4)
+			{
+				__m256i v = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i)), bias);
+				__m256i m = less ? _mm256_cmpgt_epi64(k, v) : _mm256_cmpgt_epi64(v, k);
+				c += popcount(static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(m))));
+			}
+			for (; i < n; i++)
+				c += less ? p[i] < key : key < p[i];
+			return c;
+		}
+
+		static std::size_t less(const T* p, std::size_t n, const T& key) { return count(p, n, key, true); }
+		static std::size_t greater(const T* p, std::size_t n, const T& key) { return count(p, n, key, false); }
+	};
+
+	template <class T> struct counter<T, SIGNED, 8> : counter64<T, 0> { };
+	template <class T> struct counter<T, UNSIGNED, 8> : counter64<T, 0x8000000000000000ull> { };
+#endif
+
+	// float, 8 per compare with AVX2, else 4.
+	template <class T>
+	struct counter<T, FLOATING, 4>
+	{
+		static std::size_t count(const T* p, std::size_t n, const T& key, bool less)
+		{
+			std::size_t c = 0, i = 0;
+
+#if defined(SIMD_SEARCH_AVX2)
+			const __m256 k8 = _mm256_set1_ps(key);
+			for (; i + 8 <= n; i += 8)
+			{
+				__m256 v = _mm256_loadu_ps(p + i);
+				c += popcount(static_cast<unsigned>(_mm256_movemask_ps(less ? _mm256_cmp_ps(v, k8, _CMP_LT_OQ) : _mm256_cmp_ps(v, k8, _CMP_GT_OQ))));
+			}
+#endif
+			const __m128 k4 = _mm_set1_ps(key);
+			for (; i + 4 <= n; i += 4)
+			{
+				__m128 v = _mm_loadu_ps(p + i);
+				c += popcount(static_cast<unsigned>(_mm_movemask_ps(less ? _mm_cmplt_ps(v, k4) : _mm_cmpgt_ps(v, k4))));
+			}
+			for (; i < n; i++)
+				c += less ? p[i] < key : key < p[i];
+			return c;
+		}
+
+		static std::size_t less(const T* p, std::size_t n, const T& key) { return count(p, n, key, true); }
+		static std::size_t greater(const T* p, std::size_t n, const T& key) { return count(p, n, key, false); }
+	};
+
+	// double, 4 per compare with AVX2, else 2.
+	template <class T>
+	struct counter<T, FLOATING, 8>
+	{
+		static std::size_t count(const T* p, std::size_t n, const T& key, bool less)
+		{
+			std::size_t c = 0, i = 0;
+
+#if defined(SIMD_SEARCH_AVX2)
+			const __m256d k4 = _mm256_set1_pd(key);
+			for (; i + 4 <= n; i += 4)
+			{
+				__m256d v = _mm256_loadu_pd(p + i);
+				c += popcount(static_cast<unsigned>(_mm256_movemask_pd(less ? _mm256_cmp_pd(v, k4, _CMP_LT_OQ) : _mm256_cmp_pd(v, k4, _CMP_GT_OQ))));
+			}
+#endif
+			const __m128d k2 = _mm_set1_pd(key);
+			for (; i + 2 <= n; i += 2)
+			{
+				__m128d v = _mm_loadu_pd(p + i);
+				c += popcount(static_cast<unsigned>(_mm_movemask_pd(less ? _mm_cmplt_pd(v, k2) : _mm_cmpgt_pd(v, k2))));
+			}
+			for (; i < n; i++)
+				c += less ? p[i] < key : key < p[i];
+			return c;
+		}
+
+		static std::size_t less(const T* p, std::size_t n, const T& key) { return count(p, n, key, true); }
+		static std::size_t greater(const T* p, std::size_t n, const T& key) { return count(p, n, key, false); }
+	};
+#endif
+
+	// First element of sorted [first, last) not less than key.
+	template <class T>
+	const T* lowerBound(const T* first, const T* last, const T& key)
+	{
+		std::size_t n = static_cast<std::size_t>(last - first);
+
+		while (n > LINEAR_MAX)
+		{
+			std::size_t half = n / 2;
+			if (first[half] < key)
+			{
+				first += half + 1;
+				n -= half + 1;
+			}
+			else
+				n = half;
+		}
+
+		return first + counter<T>::less(first, n, key);
+	}
+
+	template <class T>
+	T* lowerBound(T* first, T* last, const T& key)
+	{
+		return const_cast<T*>(lowerBound(const_cast<const T*>(first), const_cast<const T*>(last), key));
+	}
+
+	// First element of sorted [first, last) greater than key.
+	template <class T>
+	const T* upperBound(const T* first, const T* last, const T& key)
+	{
+		std::size_t n = static_cast<std::size_t>(last - first);
+
+		while (n > LINEAR_MAX)
+		{
+			std::size_t half = n / 2;
+			if (!(key < first[half]))
+			{
+				first += half + 1;
+				n -= half + 1;
+			}
+			else
+				n = half;
+		}
+
+		return first + (n - counter<T>::greater(first, n, key));
+	}
+
+	template <class T>
+	T* upperBound(T* first, T* last, const T& key)
+	{
+		return const_cast<T*>(upperBound(const_cast<const T*>(first), const_cast<const T*>(last), key));
+	}
+
+	// Index of byte b among the first n of 16 key bytes, -1 if absent.
+	// All 16 bytes are read, those past n are ignored.
+	inline int findByte16(const unsigned char* keys, unsigned n, unsigned char b)
+	{
+#if defined(SIMD_SEARCH_SSE2)
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys));
+		unsigned m = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(static_cast<char>(b)))));
+		m &= (1u << n) - 1;
+		return m ? static_cast<int>(lowestBit(m)) : -1;
+#else
+		for (unsigned i = 0; i < n; i++)
+			if (keys[i] == b)
+				return static_cast<int>(i);
+		return -1;
+#endif
+	}
+
+	// Position of the first of n sorted key bytes (of 16 readable) not
+	// less than b, n if none.
+	inline unsigned lowerBoundByte16(const unsigned char* keys, unsigned n, unsigned char b)
+	{
+#if defined(SIMD_SEARCH_SSE2)
+		const __m128i bias = _mm_set1_epi8(static_cast<char>(0x80));
+		__m128i v = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys)), bias);
+		__m128i k = _mm_xor_si128(_mm_set1_epi8(static_cast<char>(b)), bias);
+		unsigned m = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpgt_epi8(k, v)));
+		return popcount(m & ((1u << n) - 1));
+#else
+		unsigned i = 0;
+		while (i < n && keys[i] < b)
+			i++;
+		return i;
+#endif
+	}
+}
+
+#endif
@@ -33,12 +33,17 @@
 *   09/29/2018: Added remove function. JME
 *   09/29/2018: Added very basic iterator support. JME
 *   09/29/2018: Converted to use smart pointers. JME
+*   10/18/2026: Iterative destructor, end() valid on an empty list,
+*               iterator typedefs instead of deprecated std::iterator.
 *************************************************************************/
 #ifndef SL_LIST_H
 #define SL_LIST_H
 
 #include <iostream> // cout
+#include <cstddef>  // ptrdiff_t
+#include <iterator> // iterator tags
 #include <memory>   // smart pointer
+#include <utility>  // move
 
 namespace myList 
 {
@@ -67,8 +72,9 @@ namespace myList
 	public:
 		// Ctor.
 		list() : head(nullptr), tail(nullptr), count(0) { }
-		// Dtor.
-		~list() { } // Use of smart pointers precludes doing something here.
+		// Dtor. Unlinks nodes one at a time, releasing the head alone would
+		// recurse through every next pointer and overflow on long lists.
+		~list() { while (head) head = std::move(head->next); }
 
 		T& back() const;               // Returns element at tail of list.
 		bool empty() const;            // Returns true if list is empty.
@@ -85,9 +91,16 @@ namespace myList
 		}
 
 		//
-		// Inner iterator class. Member typedefs provided through inheritance of std::iterator.
-		class iterator : public std::iterator<std::forward_iterator_tag, T>
+		// Inner iterator class.
+		class iterator
 		{
+		public:
+			typedef std::forward_iterator_tag iterator_category;
+			typedef T value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef T* pointer;
+			typedef T& reference;
+
 		private:
 			std::shared_ptr<Node<T>> pNode;
 
@@ -121,7 +134,7 @@ namespace myList
 		// Begin and end iterators.
 		iterator begin() const { return iterator(head); }
 		//iterator end() const { return iterator(tail); }
-		iterator end() const { return iterator(tail->next); }
+		iterator end() const { return iterator(nullptr); }
 	};
 
 
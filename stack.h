@@ -15,12 +15,16 @@
 * Change Log:
 *  10/26/2018: Initial release. JME
 *  10/29/2018: Added rezize stack to push. JME
+*  10/18/2026: Fixed push dropping the value (and never growing past N)
+*              once the initial capacity was reached.
+*  10/18/2026: Include stdexcept for out_of_range.
 *************************************************************************/
 #ifndef _ARRAY_STACK_H_
 #define _ARRAY_STACK_H_
 
-#include <exception> // out of range
+#include <stdexcept> // out of range
 #include <memory>    // unique pointer
+#include <utility>   // move
 
 // Default size of stack array if not specified during instantiation.
 const std::size_t DEFAULT_STACK_SIZE = 16;
@@ -31,9 +35,10 @@ class Stack
 private:
 	std::unique_ptr<T[]> data;
 	std::size_t index;
+	std::size_t capacity;
 
 public:
-	Stack() : index(0) { data = std::make_unique<T[]>(N); }
+	Stack() : index(0), capacity(N) { data = std::make_unique<T[]>(N); }
 	~Stack() = default;
 
 	T top()
@@ -61,19 +66,18 @@ public:
 
 	void push(T value)
 	{
-		if (index < N)
-			data[index++] = value;
-		else
+		if (index == capacity)
 		{
 			//throw std::out_of_range("stack full");
 			// Double stack capacity.
-			std::size_t newSize = (index + 1) * 2;
+			std::size_t newSize = capacity ? capacity * 2 : 1;
 			std::unique_ptr<T[]> temp(static_cast<T*>(data.release()));
-			data.reset();
 			data = std::make_unique<T[]>(newSize);
 			for (std::size_t i = 0; i < index; i++)
-				data[i] = temp[i];
+				data[i] = std::move(temp[i]);
+			capacity = newSize;
 		}
+		data[index++] = value;
 	}
 
 	bool empty() { return (index == 0); }
@@ -0,0 +1,535 @@
+/*************************************************************************
+* Title: String Key Tree
+* File: string_tree.h
+* Date: 10/18/2026
+*
+* Binary search tree specialized for string keys, and a front coded,
+* read-only snapshot of it:
+*
+*   stringTree
+*     clear()      // deletes tree.
+*     empty()      // returns true if tree is empty.
+*     size()       // returns tree size (number of keys), O(1).
+*     add(s)       // insert key. does NOT check if s already exists.
+*     search(s)    // non-recursive search, returns true if s is found.
+*     getHeight()  // returns height of tree.
+*     balance()    // relinks nodes in place as a balanced tree.
+*     freeze()     // front coded snapshot of the keys (frozenStrings).
+*     begin()/end()// in-order (sorted) forward iteration.
+*
+*   frozenStrings
+*     size(), empty(), search(s), bytes(), begin()/end()
+*
+* Notes:
+*  (1) Each node holds the first 8 key bytes as a big-endian integer,
+*      zero padded, so most comparisons are one integer compare. Only
+*      keys sharing those 8 bytes compare their remaining bytes, which
+*      live in one arena shared by all nodes. Ordering is the same as
+*      std::string's (bytes compared unsigned, shorter prefix first).
+*  (2) Nodes are kept in one array and linked by 32-bit index, so a
+*      tree holds at most 2^32 - 1 keys.
+*  (3) frozenStrings stores keys in blocks of BLOCK keys. The first key
+*      of a block is stored whole, the others as the length shared with
+*      the previous key plus the remaining bytes. Searches binary search
+*      the block heads, then decode one block.
+*  (4) Iterators rebuild each key as a std::string, dereferencing
+*      returns a reference to that copy.
+*************************************************************************
+* Change Log:
+*  10/18/2026: Initial release.
+*************************************************************************/
+#ifndef _STRING_TREE_H_
+#define _STRING_TREE_H_
+
+#include <cstdint>  // fixed width prefixes and links.
+#include <cstring>  // memcmp.
+#include <iterator> // iterator tags.
+#include <string>   // keys.
+#include <utility>  // pair.
+#include <vector>   // nodes, arena, blocks.
+
+class frozenStrings;
+
+// Key bytes [0, 8) as a big-endian integer, zero padded.
+inline std::uint64_t keyPrefix(const char* s, std::size_t n)
+{
+	std::uint64_t p = 0;
+
+	for (std::size_t i = 0; i < 8; i++)
+		p = (p << 8) | (i < n ? static_cast<unsigned char>(s[i]) : 0);
+
+	return p;
+}
+
+// Compare keys with equal prefixes on their bytes past the first 8, then
+// on length. a and b point at those bytes.
+inline int compareSuffix(const char* a, std::size_t na, const char* b, std::size_t nb)
+{
+	std::size_t m = (na < nb ? na : nb);
+
+	if (m > 8)
+	{
+		int c = std::memcmp(a, b, m - 8);
+		if (c)
+			return c;
+	}
+
+	return na < nb ? -1 : na > nb ? 1 : 0;
+}
+
+class stringTree
+{
+	static const std::uint32_t NIL = 0xFFFFFFFF;
+
+	struct node
+	{
+		std::uint64_t prefix; // First 8 bytes, big-endian.
+		std::size_t suffix;   // Arena offset of bytes past the first 8.
+		std::uint32_t length;
+		std::uint32_t left;
+		std::uint32_t right;
+	};
+
+public:
+	class iterator;
+	typedef iterator const_iterator;
+
+	stringTree() : root(NIL) { }
+
+	//
+	// Basic tree functionality.
+	//
+
+	void clear()
+	{
+		nodes.clear();
+		arena.clear();
+		root = NIL;
+	}
+
+	bool empty() const { return nodes.empty(); }
+	std::size_t size() const { return nodes.size(); }
+
+	// Add key, smaller keys go left, equal or larger keys go right.
+	void add(const std::string& s) { add(s.data(), s.size()); }
+	void add(const char* s, std::size_t n)
+	{
+		node k;
+		k.prefix = keyPrefix(s, n);
+		k.suffix = arena.size();
+		k.length = static_cast<std::uint32_t>(n);
+		k.left = k.right = NIL;
+		if (n > 8)
+			arena.insert(arena.end(), s + 8, s + n);
+
+		std::uint32_t* link = &root;
+		while (*link != NIL)
+		{
+			node& p = nodes[*link];
+			link = compare(k.prefix, s, n, p) < 0 ? &p.left : &p.right;
+		}
+
+		*link = static_cast<std::uint32_t>(nodes.size());
+		nodes.push_back(k);
+	}
+
+	// Non-recursive search.
+	bool search(const std::string& s) const { return search(s.data(), s.size()); }
+	bool search(const char* s, std::size_t n) const
+	{
+		std::uint64_t prefix = keyPrefix(s, n);
+		std::uint32_t i = root;
+
+		while (i != NIL)
+		{
+			int c = compare(prefix, s, n, nodes[i]);
+
+			if (c == 0)
+				return true;
+			i = c < 0 ? nodes[i].left : nodes[i].right;
+		}
+
+		return false;
+	}
+
+	// Height of tree, iterative.
+	int getHeight() const
+	{
+		int height = 0;
+		std::vector<std::pair<std::uint32_t, int>> stack;
+
+		if (root != NIL)
+			stack.push_back(std::make_pair(root, 1));
+		while (stack.size())
+		{
+			std::pair<std::uint32_t, int> top = stack.back();
+			stack.pop_back();
+
+			height = top.second > height ? top.second : height;
+			if (nodes[top.first].left != NIL)
+				stack.push_back(std::make_pair(nodes[top.first].left, top.second + 1));
+			if (nodes[top.first].right != NIL)
+				stack.push_back(std::make_pair(nodes[top.first].right, top.second + 1));
+		}
+
+		return height;
+	}
+
+	// Relink nodes as a balanced tree, in place.
+	void balance();
+
+	// Front coded snapshot of the keys, in sorted order.
+	frozenStrings freeze() const;
+
+	//
+	// Iterators.
+	//
+
+	iterator begin() const;
+	iterator end() const;
+	const_iterator cbegin() const;
+	const_iterator cend() const;
+
+private:
+	std::vector<node> nodes;
+	std::vector<char> arena;
+	std::uint32_t root;
+
+	const char* suffix(const node& k) const { return arena.data() + k.suffix; }
+
+	// Compare key (s, n) with prefix p against node k.
+	int compare(std::uint64_t p, const char* s, std::size_t n, const node& k) const
+	{
+		if (p != k.prefix)
+			return p < k.prefix ? -1 : 1;
+		return compareSuffix(s + 8, n, suffix(k), k.length);
+	}
+
+	int compare(const node& a, const node& b) const
+	{
+		if (a.prefix != b.prefix)
+			return a.prefix < b.prefix ? -1 : 1;
+		return compareSuffix(suffix(a), a.length, suffix(b), b.length);
+	}
+
+	// Rebuild key of node i.
+	void key(std::uint32_t i, std::string& s) const
+	{
+		const node& k = nodes[i];
+
+		s.resize(k.length);
+		for (std::size_t b = 0; b < 8 && b < k.length; b++)
+			s[b] = static_cast<char>(k.prefix >> (56 - 8 * b));
+		if (k.length > 8)
+			s.replace(8, k.length - 8, suffix(k), k.length - 8);
+	}
+};
+
+// In-order forward iterator, keeps the path of pending nodes.
+class stringTree::iterator
+{
+	friend class stringTree;
+
+public:
+	typedef std::forward_iterator_tag iterator_category;
+	typedef std::string value_type;
+	typedef std::ptrdiff_t difference_type;
+	typedef const std::string* pointer;
+	typedef const std::string& reference;
+
+	iterator() : owner(nullptr) { }
+
+	reference operator*() const { return current; }
+	pointer operator->() const { return &current; }
+
+	iterator& operator++()
+	{
+		step();
+		if (stack.size())
+			owner->key(stack.back(), current);
+		return *this;
+	}
+	iterator operator++(int)
+	{
+		iterator old = *this;
+		++*this;
+		return old;
+	}
+
+	bool operator== (const iterator& rhs) const
+	{
+		return stack.empty() ? rhs.stack.empty() : rhs.stack.size() && stack.back() == rhs.stack.back();
+	}
+	bool operator!= (const iterator& rhs) const { return !(*this == rhs); }
+
+private:
+	explicit iterator(const stringTree* t) : owner(t)
+	{
+		descend(t->root);
+		if (stack.size())
+			owner->key(stack.back(), current);
+	}
+
+	// Push node and its left spine.
+	void descend(std::uint32_t i)
+	{
+		for (; i != NIL; i = owner->nodes[i].left)
+			stack.push_back(i);
+	}
+
+	// Move to the next node without rebuilding its key.
+	void step()
+	{
+		std::uint32_t i = stack.back();
+		stack.pop_back();
+		descend(owner->nodes[i].right);
+	}
+
+	const stringTree* owner;
+	std::vector<std::uint32_t> stack; // Back is the current node.
+	std::string current;
+};
+
+inline stringTree::iterator stringTree::begin() const { return iterator(this); }
+inline stringTree::iterator stringTree::end() const { return iterator(); }
+inline stringTree::const_iterator stringTree::cbegin() const { return begin(); }
+inline stringTree::const_iterator stringTree::cend() const { return end(); }
+
+// Read-only sorted key set, front coded.
+class frozenStrings
+{
+	friend class stringTree;
+
+public:
+	// Keys per block, each block starts with a whole key.
+	static const std::size_t BLOCK = 16;
+
+	class iterator;
+	typedef iterator const_iterator;
+
+	frozenStrings() : count(0) { }
+
+	// Build from keys in sorted order.
+	template <class InputIt>
+	frozenStrings(InputIt first, InputIt last) : count(0)
+	{
+		std::string prev;
+
+		for (; first != last; ++first)
+			append(*first, prev);
+	}
+
+	bool empty() const { return count == 0; }
+	std::size_t size() const { return count; }
+	// Encoded size in bytes.
+	std::size_t bytes() const
+	{
+		return data.size() + blocks.size() * (sizeof(std::size_t) + sizeof(std::uint64_t));
+	}
+
+	bool search(const std::string& s) const { return search(s.data(), s.size()); }
+	bool search(const char* s, std::size_t n) const
+	{
+		if (blocks.empty())
+			return false;
+
+		// Last block whose head is not greater than the key.
+		std::uint64_t p = keyPrefix(s, n);
+		std::size_t lo = 0, hi = blocks.size();
+		while (hi - lo > 1)
+		{
+			std::size_t mid = lo + (hi - lo) / 2;
+
+			if (compareHead(mid, p, s, n) <= 0)
+				lo = mid;
+			else
+				hi = mid;
+		}
+
+		// Scan the block.
+		std::string k;
+		const char* at = data.data() + blocks[lo];
+		std::size_t left = count - lo * BLOCK < BLOCK ? count - lo * BLOCK : BLOCK;
+		for (std::size_t i = 0; i < left; i++)
+		{
+			at = decode(at, k, i == 0);
+
+			int c = k.compare(0, k.size(), s, n);
+			if (c == 0)
+				return true;
+			if (c > 0)
+				return false;
+		}
+
+		return false;
+	}
+
+	iterator begin() const;
+	iterator end() const;
+	const_iterator cbegin() const;
+	const_iterator cend() const;
+
+private:
+	std::vector<char> data;             // Encoded keys.
+	std::vector<std::size_t> blocks;    // Offset of each block in data.
+	std::vector<std::uint64_t> heads;   // Prefix of each block's first key.
+	std::size_t count;
+
+	static void putVarint(std::vector<char>& out, std::size_t v)
+	{
+		for (; v >= 0x80; v >>= 7)
+			out.push_back(static_cast<char>(v | 0x80));
+		out.push_back(static_cast<char>(v));
+	}
+
+	static const char* getVarint(const char* at, std::size_t& v)
+	{
+		v = 0;
+		for (int shift = 0; ; shift += 7)
+		{
+			unsigned char b = static_cast<unsigned char>(*at++);
+			v |= static_cast<std::size_t>(b & 0x7F) << shift;
+			if (!(b & 0x80))
+				return at;
+		}
+	}
+
+	// Append next key, prev holds the previous one.
+	void append(const std::string& s, std::string& prev)
+	{
+		std::size_t shared = 0;
+
+		if (count % BLOCK == 0)
+		{
+			blocks.push_back(data.size());
+			heads.push_back(keyPrefix(s.data(), s.size()));
+		}
+		else
+			while (shared < s.size() && shared < prev.size() && s[shared] == prev[shared])
+				shared++;
+
+		if (count % BLOCK)
+			putVarint(data, shared);
+		putVarint(data, s.size() - shared);
+		data.insert(data.end(), s.begin() + shared, s.end());
+
+		prev = s;
+		count++;
+	}
+
+	// Decode key at, k holding the previous key unless head.
+	static const char* decode(const char* at, std::string& k, bool head)
+	{
+		std::size_t shared = 0, rest;
+
+		if (!head)
+			at = getVarint(at, shared);
+		at = getVarint(at, rest);
+		k.resize(shared);
+		k.append(at, rest);
+
+		return at + rest;
+	}
+
+	// Compare head key of block b with key (s, n) whose prefix is p.
+	int compareHead(std::size_t b, std::uint64_t p, const char* s, std::size_t n) const
+	{
+		if (heads[b] != p)
+			return heads[b] < p ? -1 : 1;
+
+		std::size_t length;
+		const char* at = getVarint(data.data() + blocks[b], length);
+		return compareSuffix(at + 8, length, s + 8, n);
+	}
+};
+
+// Forward iterator decoding keys in order.
+class frozenStrings::iterator
+{
+	friend class frozenStrings;
+
+public:
+	typedef std::forward_iterator_tag iterator_category;
+	typedef std::string value_type;
+	typedef std::ptrdiff_t difference_type;
+	typedef const std::string* pointer;
+	typedef const std::string& reference;
+
+	iterator() : owner(nullptr), at(nullptr), index(0) { }
+
+	reference operator*() const { return current; }
+	pointer operator->() const { return &current; }
+
+	iterator& operator++()
+	{
+		if (++index < owner->count)
+			at = decode(at, current, index % BLOCK == 0);
+		return *this;
+	}
+	iterator operator++(int)
+	{
+		iterator old = *this;
+		++*this;
+		return old;
+	}
+
+	bool operator== (const iterator& rhs) const { return index == rhs.index; }
+	bool operator!= (const iterator& rhs) const { return !(*this == rhs); }
+
+private:
+	iterator(const frozenStrings* f, std::size_t i) : owner(f), at(f->data.data()), index(i)
+	{
+		if (index < owner->count)
+			at = decode(at, current, true);
+	}
+
+	const frozenStrings* owner;
+	const char* at; // Next encoded key.
+	std::size_t index;
+	std::string current;
+};
+
+inline frozenStrings::iterator frozenStrings::begin() const { return iterator(this, 0); }
+inline frozenStrings::iterator frozenStrings::end() const { return iterator(this, count); }
+inline frozenStrings::const_iterator frozenStrings::cbegin() const { return begin(); }
+inline frozenStrings::const_iterator frozenStrings::cend() const { return end(); }
+
+// Relink nodes as a balanced tree, in place.
+inline void stringTree::balance()
+{
+	std::vector<std::uint32_t> order;
+	order.reserve(nodes.size());
+	for (iterator it = begin(); it != end(); it.step())
+		order.push_back(it.stack.back());
+
+	// Pending [lo, hi) ranges and the link each is attached to.
+	struct span { std::size_t lo, hi; std::uint32_t* link; };
+	std::vector<span> spans;
+
+	spans.push_back(span{ 0, order.size(), &root });
+	while (spans.size())
+	{
+		span r = spans.back();
+		spans.pop_back();
+
+		if (r.lo >= r.hi)
+		{
+			*r.link = NIL;
+			continue;
+		}
+
+		// Keep duplicates of the middle key in the right subtree (as add).
+		std::size_t mid = r.lo + (r.hi - r.lo) / 2;
+		while (mid > r.lo && compare(nodes[order[mid - 1]], nodes[order[mid]]) == 0)
+			--mid;
+
+		node& n = nodes[order[mid]];
+		*r.link = order[mid];
+		spans.push_back(span{ r.lo, mid, &n.left });
+		spans.push_back(span{ mid + 1, r.hi, &n.right });
+	}
+}
+
+inline frozenStrings stringTree::freeze() const { return frozenStrings(begin(), end()); }
+
+#endif
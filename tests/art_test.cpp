@@ -0,0 +1,168 @@
+/*************************************************************************
+* Title: Adaptive Radix Tree Test
+* File: art_test.cpp
+* Date: 10/18/2026
+*
+* Runs artSet against std::set on signed ints, 64-bit keys and strings
+* sharing long prefixes: random inserts and removes, dense runs that grow
+* nodes to node256, then erasing everything so every node shrinks back
+* down. Search, lowerBound and iteration are compared throughout. Exits
+* non-zero on failure.
+*************************************************************************/
+#undef NDEBUG // Checks below must run in every build type.
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+#include "../art.h"
+
+template <class T>
+static void check(const artSet<T>& a, const std::set<T>& ref, const std::vector<T>& probes)
+{
+	assert(a.size() == ref.size() && a.empty() == ref.empty());
+
+	typename std::set<T>::const_iterator expected = ref.begin();
+	for (typename artSet<T>::iterator it = a.begin(); it != a.end(); ++it, ++expected)
+		assert(expected != ref.end() && *it == *expected);
+	assert(expected == ref.end());
+
+	if (!ref.empty())
+		assert(a.lowerBound() == *ref.begin() && a.upperBound() == *ref.rbegin());
+
+	for (const T& p : probes)
+	{
+		assert(a.search(p) == (ref.count(p) != 0));
+
+		typename artSet<T>::iterator it = a.lowerBound(p);
+		typename std::set<T>::const_iterator at = ref.lower_bound(p);
+		if (at == ref.end())
+			assert(it == a.end());
+		else
+			assert(it != a.end() && *it == *at);
+	}
+}
+
+// Random inserts and removes over keys, checked every step, then every
+// key erased in random order down to an empty set.
+template <class T>
+static void differential(std::vector<T> keys, unsigned seed)
+{
+	artSet<T> a;
+	std::set<T> ref;
+	std::mt19937 rng(seed);
+
+	for (std::size_t i = 0; i < keys.size() * 4; i++)
+	{
+		const T& k = keys[rng() % keys.size()];
+		if (rng() % 3)
+			assert(a.insert(k) == ref.insert(k).second);
+		else
+			assert(a.remove(k) == (ref.erase(k) != 0));
+		if (i % 997 == 0)
+			check(a, ref, keys);
+	}
+	check(a, ref, keys);
+
+	// Fill to every key, then erase to empty.
+	for (const T& k : keys)
+	{
+		a.insert(k);
+		ref.insert(k);
+	}
+	check(a, ref, keys);
+
+	artSet<T> copy(a);
+	check(copy, ref, keys);
+
+	std::shuffle(keys.begin(), keys.end(), rng);
+	for (std::size_t i = 0; i < keys.size(); i++)
+	{
+		assert(a.remove(keys[i]) == (ref.erase(keys[i]) != 0));
+		if (i % 499 == 0)
+			check(a, ref, keys);
+	}
+	check(a, ref, keys);
+	assert(a.empty() && a.begin() == a.end());
+	assert(!a.remove(keys[0]));
+
+	// Still usable after emptying, and the copy was independent.
+	assert(a.insert(keys[0]) && a.size() == 1 && *a.begin() == keys[0]);
+	check(copy, std::set<T>(keys.begin(), keys.end()), keys);
+}
+
+static void testInts()
+{
+	// Dense runs around zero and the extremes fill node256s, sparse ones
+	// leave node4s and node16s.
+	std::vector<int> keys;
+	for (int i = -600; i < 600; i++)
+		keys.push_back(i);
+	for (int i = 0; i < 300; i++)
+	{
+		keys.push_back(std::numeric_limits<int>::min() + i);
+		keys.push_back(std::numeric_limits<int>::max() - i);
+		keys.push_back(i * 65537);
+		keys.push_back(-i * 1000003);
+	}
+	differential(keys, 1);
+}
+
+static void testWide()
+{
+	std::vector<std::int64_t> keys;
+	std::vector<std::uint64_t> ukeys;
+	std::mt19937_64 rng(2);
+
+	for (int i = 0; i < 256; i++)
+	{
+		keys.push_back(std::numeric_limits<std::int64_t>::min() + i);
+		keys.push_back(std::numeric_limits<std::int64_t>::max() - i);
+		keys.push_back(static_cast<std::int64_t>(i) << 40);
+		ukeys.push_back(std::numeric_limits<std::uint64_t>::max() - i);
+		ukeys.push_back(static_cast<std::uint64_t>(i) << 56 | 0x8000);
+		ukeys.push_back(i);
+	}
+	for (int i = 0; i < 2000; i++)
+	{
+		keys.push_back(static_cast<std::int64_t>(rng()));
+		ukeys.push_back(rng() >> (i % 64));
+	}
+	differential(keys, 3);
+	differential(ukeys, 4);
+}
+
+static void testStrings()
+{
+	// Prefixes longer than MAX_PREFIX, keys that are prefixes of others,
+	// embedded and trailing NULs, the empty string.
+	const std::string stems[] = {
+		"", "a", "ab", "abcdefghijklmnopqrstuvwxyz", "abcdefghijklmnopqrstuvwxyA",
+		"http://example.com/path/to/resource/", std::string("nul\0mid", 7),
+		std::string("\0", 1), std::string("\0\0", 2), std::string("\xFF\xFF", 2)
+	};
+
+	std::vector<std::string> keys;
+	for (const std::string& s : stems)
+	{
+		keys.push_back(s);
+		for (int i = 0; i < 300; i++)
+		{
+			keys.push_back(s + std::to_string(i));
+			keys.push_back(s + std::string(1, static_cast<char>(i)));
+		}
+		keys.push_back(s + std::string(1, '\0'));
+	}
+	differential(keys, 5);
+}
+
+int main()
+{
+	testInts();
+	testWide();
+	testStrings();
+	return 0;
+}
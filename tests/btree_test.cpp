@@ -0,0 +1,110 @@
+/*************************************************************************
+* Title: B+ Tree Test
+* File: btree_test.cpp
+* Date: 10/18/2026
+*
+* Fills disk B+ trees in sorted, reverse and random order through a
+* buffer pool of minimum size, enough keys for leaf and inner splits and
+* steady eviction, and checks search, lowerBound and iteration against
+* std::set. Each file is then closed, reopened and checked again. Exits
+* non-zero on failure.
+*************************************************************************/
+#undef NDEBUG // Checks below must run in every build type.
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+#include "../btree.h"
+
+typedef std::int64_t key;
+
+// Every check against the reference set. Keys are even, so odd probes
+// fall between them.
+static void check(const btree<key>& t, const std::set<key>& ref)
+{
+	assert(t.size() == ref.size());
+
+	std::set<key>::const_iterator expected = ref.begin();
+	for (btree<key>::iterator it = t.begin(); it != t.end(); ++it, ++expected)
+		assert(expected != ref.end() && *it == *expected);
+	assert(expected == ref.end());
+
+	assert(t.lowerBound() == *ref.begin() && t.upperBound() == *ref.rbegin());
+
+	std::mt19937 rng(7);
+	const key top = *ref.rbegin() + 2;
+	for (int i = 0; i < 20000; i++)
+	{
+		const key probe = static_cast<key>(rng() % (top + 2)) - 1;
+		assert(t.search(probe) == (ref.count(probe) != 0));
+
+		btree<key>::iterator it = t.lowerBound(probe);
+		std::set<key>::const_iterator at = ref.lower_bound(probe);
+		if (at == ref.end())
+			assert(it == t.end());
+		else
+			assert(it != t.end() && *it == *at);
+	}
+	assert(*t.lowerBound(*ref.begin() - 1) == *ref.begin());
+	assert(t.lowerBound(*ref.rbegin() + 1) == t.end());
+}
+
+static void testOrder(const std::string& path, const std::vector<key>& keys)
+{
+	std::set<key> ref(keys.begin(), keys.end());
+	{
+		btree<key> t;
+		t.create(path, 0); // clamped to bufferPool::MIN_FRAMES.
+		for (key k : keys)
+			assert(t.insert(k));
+		for (std::size_t i = 0; i < keys.size(); i += 97)
+			assert(!t.insert(keys[i]));
+
+		// Root over inner nodes over leaves, far more pages than frames.
+		assert(t.getHeight() >= 3);
+		assert(t.poolStats().frames == bufferPool::MIN_FRAMES && t.poolStats().writes > 0);
+		check(t, ref);
+		t.close();
+	}
+
+	btree<key> t;
+	t.open(path, 0);
+	assert(t.getHeight() >= 3);
+	check(t, ref);
+
+	// Inserts after reopening extend the same file.
+	for (key k = 1; k < 2000; k += 2)
+	{
+		assert(t.insert(k));
+		ref.insert(k);
+	}
+	t.close();
+	t.open(path, 0);
+	check(t, ref);
+	t.close();
+
+	std::remove(path.c_str());
+}
+
+int main(int argc, char* argv[])
+{
+	const std::string path = argc > 1 ? argv[1] : "btree_test.bin";
+	const key n = 200000;
+
+	std::vector<key> keys;
+	for (key i = 0; i < n; i++)
+		keys.push_back(2 * i);
+
+	testOrder(path, keys);
+
+	std::reverse(keys.begin(), keys.end());
+	testOrder(path, keys);
+
+	std::shuffle(keys.begin(), keys.end(), std::mt19937(1));
+	testOrder(path, keys);
+	return 0;
+}
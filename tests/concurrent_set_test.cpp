@@ -0,0 +1,115 @@
+/*************************************************************************
+* Title: Concurrent Set Test
+* File: concurrent_set_test.cpp
+* Date: 10/18/2026
+*
+* Writer threads add and remove keys of overlapping ranges while reader
+* threads search and iterate. Successful adds and removes of one key
+* alternate, so replaying them serially into a std::set leaves a key in
+* exactly when it has one more add than removes; the set must end with
+* the same contents. Readers check iteration stays strictly ascending.
+* Exits non-zero on failure.
+*************************************************************************/
+#undef NDEBUG // Checks below must run in every build type.
+#include <atomic>
+#include <cassert>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+#include "../concurrent_set.h"
+
+// Key counting the copies the set makes into its nodes and how many of
+// them were destroyed, so reclamation is seen to happen.
+struct key
+{
+	static std::atomic<long> copies, freed;
+
+	int v;
+	bool copy = false;
+
+	explicit key(int v) : v(v) { }
+	key(const key& rhs) : v(rhs.v), copy(true) { copies++; }
+	~key() { freed += copy; }
+
+	bool operator< (const key& rhs) const { return v < rhs.v; }
+};
+std::atomic<long> key::copies{ 0 }, key::freed{ 0 };
+
+int main()
+{
+	const int writers = 4, readers = 2, span = 1024, stride = 256, ops = 100000;
+	const int keys = stride * (writers - 1) + span;
+
+	std::vector<std::vector<long>> adds(writers, std::vector<long>(keys)), removes = adds;
+	std::atomic<int> running{ writers };
+	long reclaimedWhileRunning = 0;
+	{
+		concurrentSet<key> s;
+		std::vector<std::thread> threads;
+
+		// Writer w works on [w * stride, w * stride + span), overlapping its
+		// neighbours.
+		for (int w = 0; w < writers; w++)
+			threads.emplace_back([&, w]() {
+				std::mt19937 rng(w + 1);
+				for (int i = 0; i < ops; i++)
+				{
+					const key k(w * stride + static_cast<int>(rng() % span));
+					unsigned op = rng() % 4;
+
+					if (op == 0)
+						s.search(k);
+					else if (op & 1)
+						adds[w][k.v] += s.add(k);
+					else
+						removes[w][k.v] += s.remove(k);
+				}
+				running--;
+			});
+
+		for (int r = 0; r < readers; r++)
+			threads.emplace_back([&]() {
+				std::size_t passes = 0;
+				while (running.load() || !passes)
+				{
+					int last = -1;
+					for (auto it = s.begin(); it != s.end(); ++it)
+					{
+						assert(it->v > last && it->v < keys);
+						last = it->v;
+					}
+					passes++;
+				}
+			});
+
+		for (std::thread& t : threads)
+			t.join();
+		reclaimedWhileRunning = key::freed.load();
+
+		// Serial replay of the successful operations.
+		std::set<int> ref;
+		for (int k = 0; k < keys; k++)
+		{
+			long net = 0;
+			for (int w = 0; w < writers; w++)
+				net += adds[w][k] - removes[w][k];
+			assert(net == 0 || net == 1);
+			if (net)
+				ref.insert(k);
+			assert(s.search(key(k)) == (net == 1));
+		}
+
+		assert(s.size() == ref.size());
+		auto expected = ref.begin();
+		for (auto it = s.begin(); it != s.end(); ++it, ++expected)
+			assert(expected != ref.end() && it->v == *expected);
+		assert(expected == ref.end());
+		if (!ref.empty())
+			assert(s.lowerBound().v == *ref.begin() && s.upperBound().v == *ref.rbegin());
+	}
+
+	// Removed nodes were freed through the epoch domain during the run.
+	assert(reclaimedWhileRunning > 0 && key::freed.load() <= key::copies.load());
+	return 0;
+}
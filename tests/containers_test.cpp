@@ -0,0 +1,772 @@
+/*************************************************************************
+* Title: Containers Test
+* File: containers_test.cpp
+* Date: 10/18/2026
+*
+* Runs each container next to its standard library counterpart on the
+* same random keys and checks they agree. Exits non-zero on failure.
+*************************************************************************/
+#undef NDEBUG // Checks below must run in every build type.
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <forward_list>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <stack>
+#include <thread>
+#include <vector>
+#include "../map.h"
+#include "../multiset.h"
+#include "../queue.h"
+#include "../set.h"
+#include "../shared_tree.h"
+#include "../slist.h"
+#include "../stack.h"
+#include "../tree.h"
+#include "../tree_with_parent.h"
+#include "../vector.h"
+
+// Iterates the same keys as ref, in order.
+template <class Container, class Reference>
+static bool sameKeys(const Container& c, const Reference& ref)
+{
+	auto it = c.begin(), end = c.end();
+	for (int k : ref)
+	{
+		if (!(it != end) || *it != k)
+			return false;
+		++it;
+	}
+	return !(it != end);
+}
+
+static void testTree(const std::vector<int>& keys)
+{
+	Tree<int> t;
+	std::multiset<int> ref(keys.begin(), keys.end());
+	for (int k : keys)
+		t.add(k);
+
+	for (int k = -1; k <= 1000; k++)
+		assert(t.search(k) == (ref.count(k) != 0));
+
+	for (std::size_t i = 0; i < keys.size(); i += 3)
+	{
+		assert(t.remove(keys[i]));
+		ref.erase(ref.find(keys[i]));
+	}
+	for (int k = -1; k <= 1000; k++)
+		assert(t.search(k) == (ref.count(k) != 0));
+
+	t.balance();
+	for (int k : ref)
+		assert(t.search(k));
+
+	// Duplicates may leave runs on one side, balance distinct keys.
+	Tree<int> distinct;
+	for (int k : std::set<int>(ref.begin(), ref.end()))
+		distinct.add(k);
+	distinct.balance();
+	assert(distinct.isBalanced());
+}
+
+static void testTreeWithParent(const std::vector<int>& keys)
+{
+	tree<int> t;
+	std::multiset<int> ref(keys.begin(), keys.end());
+	for (int k : keys)
+		t.add(k);
+	assert(t.size() == ref.size());
+	assert(sameKeys(t, ref));
+
+	// Batched searches agree with single ones.
+	std::vector<int> probes;
+	for (int k = -1; k <= 1000; k++)
+		probes.push_back(k);
+	std::unique_ptr<bool[]> found(new bool[probes.size()]);
+	std::size_t hits = t.search_many(probes.data(), probes.size(), found.get());
+	std::size_t expected = 0;
+	for (std::size_t i = 0; i < probes.size(); i++)
+	{
+		assert(found[i] == (ref.count(probes[i]) != 0));
+		assert(t.search(probes[i]) == found[i]);
+		expected += found[i];
+	}
+	assert(hits == expected);
+
+	// Filter and cache must not change answers.
+	t.enableFilter();
+	t.enableCache(64);
+	for (int k = -1; k <= 1000; k++)
+		assert(t.search(k) == (ref.count(k) != 0));
+
+	// Round trip through save and load.
+	t.balance();
+	std::stringstream ss;
+	t.save(ss);
+	tree<int> copy;
+	copy.load(ss);
+	assert(sameKeys(copy, ref));
+
+	// A corrupted key count, one key too many up to a block no memory
+	// holds, is refused and leaves the tree as it was.
+	const std::string image = ss.str();
+	const std::size_t countAt = 16; // After magic, version, byte order and key size.
+	for (std::uint64_t bad : { std::uint64_t(ref.size() + 1), std::uint64_t(1) << 40, ~std::uint64_t(0) })
+	{
+		std::string corrupt = image;
+		std::memcpy(&corrupt[countAt], &bad, sizeof(bad));
+		std::istringstream is(corrupt);
+		try
+		{
+			copy.load(is);
+			assert(!"corrupted count loaded");
+		}
+		catch (const std::runtime_error& e)
+		{
+			assert(std::string(e.what()) == "tree::load: key count exceeds stream");
+		}
+		assert(sameKeys(copy, ref));
+	}
+}
+
+// Sorted adds leave a key per level, a million levels deep. Copy, clear,
+// assignment and destruction must not recurse per level.
+static void testSortedTrees()
+{
+	const int n = 1000000;
+	{
+		Tree<int> t;
+		for (int k = 0; k < n; k++)
+			t.add(k);
+		assert(t.getHeight() == n && t.stats().nodes == static_cast<std::size_t>(n));
+
+		Tree<int> copy(t);
+		assert(copy.search(0) && copy.search(n - 1) && !copy.search(n));
+		t.clear();
+		assert(t.empty() && !t.search(0));
+		t = copy;
+		assert(t.getHeight() == n && t.search(n / 2));
+	}
+	{
+		tree<int> t;
+		for (int k = 0; k < n; k++)
+			t.add(k);
+		assert(t.size() == static_cast<std::size_t>(n) && t.getHeight() == n);
+
+		tree<int> copy(t);
+		int expected = 0;
+		for (int k : copy)
+			assert(k == expected++);
+		assert(expected == n);
+		t.clear();
+		assert(t.empty() && t.begin() == t.end());
+		t = copy;
+		assert(t.size() == static_cast<std::size_t>(n) && t.search(n - 1));
+	}
+}
+
+// Levels the automatic rebalancing keeps a tree of n keys within.
+static bool withinDepth(const treeStats& s, double depthFactor)
+{
+	return s.height <= depthFactor * std::log2(static_cast<double>(s.nodes)) + 1;
+}
+
+static void testAutoBalance()
+{
+	typedef tree<int>::autoBalanceKnobs knobs;
+
+	// Sorted and reverse sorted adds stay within the depth bound.
+	{
+		const int n = 1000000;
+		tree<int> t;
+		t.enableAutoBalance();
+		for (int k = 0; k < n; k++)
+		{
+			t.add(k);
+			if ((k & (k + 1)) == 0 && k >= 1023)
+				assert(withinDepth(t.stats(), knobs().depthFactor));
+		}
+		assert(withinDepth(t.stats(), knobs().depthFactor) && t.autoBalances() > 0);
+
+		int expected = 0;
+		for (int k : t)
+			assert(k == expected++);
+		assert(expected == n && t.size() == static_cast<std::size_t>(n));
+	}
+	{
+		knobs k;
+		k.depthFactor = 2.0;
+		tree<int> t;
+		t.enableAutoBalance(k);
+		for (int i = 200000; i > 0; i--)
+			t.add(i);
+		assert(withinDepth(t.stats(), k.depthFactor));
+		assert(*t.begin() == 1 && *--t.end() == 200000);
+	}
+
+	// No rebuild below minSize keys.
+	{
+		knobs k;
+		k.minSize = 1000;
+		tree<int> t;
+		t.enableAutoBalance(k);
+		for (int i = 1; i < 1000; i++)
+			t.add(i);
+		assert(t.autoBalances() == 0 && t.getHeight() == 999);
+		t.add(1000);
+		assert(t.autoBalances() == 1 && withinDepth(t.stats(), k.depthFactor));
+	}
+
+	// spacing * size adds and removes between rebuilds, size as of the
+	// last rebuild or of enabling.
+	{
+		knobs k;
+		k.spacing = 1.0;
+		k.minSize = 0;
+		tree<int> t;
+		for (int i = 0; i < 1000; i++)
+			t.add(i);
+		t.balance();
+		t.enableAutoBalance(k);
+		for (int i = 1000; i < 1999; i++)
+			t.add(i);
+		assert(t.autoBalances() == 0 && t.getHeight() > 900);
+		t.add(1999);
+		assert(t.autoBalances() == 1 && withinDepth(t.stats(), k.depthFactor));
+		int expected = 0;
+		for (int key : t)
+			assert(key == expected++);
+		assert(expected == 2000 && t.size() == 2000);
+	}
+
+	// Knobs out of range are rejected, leaving rebalancing off.
+	const double bad[][2] = { { 0.5, 0.0 }, { 0.0, 0.0 }, { std::nan(""), 0.0 }, { 2.0, -1.0 }, { 2.0, std::nan("") } };
+	for (const double* b : bad)
+	{
+		knobs k;
+		k.depthFactor = b[0];
+		k.spacing = b[1];
+		tree<int> t;
+		bool threw = false;
+		try
+		{
+			t.enableAutoBalance(k);
+		}
+		catch (const std::invalid_argument&)
+		{
+			threw = true;
+		}
+		assert(threw && !t.autoBalancing());
+	}
+}
+
+// Ends stay O(1) and exact through every kind of change.
+static void testTreeIterators(const std::vector<int>& keys)
+{
+	tree<int> t;
+	assert(t.begin() == t.end() && t.rbegin() == t.rend());
+
+	std::multiset<int> ref(keys.begin(), keys.end());
+	t.insert_batch(keys.begin(), keys.begin() + keys.size() / 2);
+	for (std::size_t i = keys.size() / 2; i < keys.size(); i++)
+		t.add(keys[i]);
+
+	// Backwards from end(), forwards again from rend().
+	auto back = ref.rbegin();
+	for (auto it = t.end(); it != t.begin(); ++back)
+		assert(*--it == *back);
+	assert(back == ref.rend());
+	auto rit = t.rend();
+	auto fwd = ref.begin();
+	for (; rit != t.rbegin(); ++fwd)
+		assert(*--rit == *fwd);
+	assert(*rit == *ref.rbegin());
+	tree<int>::const_iterator cit = t.cbegin();
+	assert(*cit++ == *ref.begin() && *cit == *std::next(ref.begin()));
+
+	auto ends = [&](const tree<int>& c) {
+		return ref.empty() ? c.begin() == c.end() : *c.begin() == *ref.begin() && *--c.end() == *ref.rbegin() && *c.rbegin() == *ref.rbegin();
+	};
+	tree<int> copy(t);
+	assert(ends(copy) && sameKeys(copy, ref));
+
+	// Appends at end(), removals from both ends and the middle.
+	for (int k = 1000; k < 1100; k++)
+	{
+		auto it = t.insert(t.end(), k);
+		assert(*it == k);
+		ref.insert(k);
+	}
+	assert(ends(t));
+	t.balance();
+	assert(ends(t));
+	for (std::size_t i = 0; !ref.empty(); i++)
+	{
+		int k = i % 3 == 0 ? *ref.begin() : i % 3 == 1 ? *ref.rbegin() : keys[i % keys.size()];
+		if (t.remove(k))
+			ref.erase(ref.find(k));
+		assert(ends(t));
+	}
+	assert(t.empty() && t.begin() == t.end());
+}
+
+// A key without a default constructor, which no container may need.
+struct noDefault
+{
+	explicit noDefault(int k) : key(k) { }
+	int key;
+
+	bool operator< (const noDefault& rhs) const { return key < rhs.key; }
+	bool operator== (const noDefault& rhs) const { return key == rhs.key; }
+};
+
+static void testNoDefault(const std::vector<int>& keys)
+{
+	tree<noDefault> t;
+	set<noDefault> s;
+	multiset<noDefault> m;
+	map<int, noDefault> p;
+	sharedTree<noDefault> shared;
+	std::multiset<int> ref;
+	for (int k : keys)
+	{
+		t.add(noDefault(k));
+		s.insert(noDefault(k));
+		m.add(noDefault(k));
+		p.try_emplace(k, k);
+		shared.add(noDefault(k));
+		ref.insert(k);
+	}
+	for (std::size_t i = 0; i < keys.size(); i += 3)
+		if (t.remove(noDefault(keys[i])))
+			ref.erase(ref.find(keys[i]));
+
+	std::vector<int> got;
+	for (const noDefault& k : t)
+		got.push_back(k.key);
+	assert(got == std::vector<int>(ref.begin(), ref.end()));
+	const std::set<int> distinct(keys.begin(), keys.end());
+	assert(s.size() == distinct.size() && m.distinct() == distinct.size() && p.size() == distinct.size());
+	assert(s.begin()->key == *distinct.begin() && p.at(*distinct.rbegin()).key == *distinct.rbegin());
+	assert(m.size() == keys.size() && shared.read()->size() == keys.size());
+}
+
+// Standard algorithms and containers take tree iterator ranges.
+static void testIteratorRanges(const std::vector<int>& keys)
+{
+	tree<int> t;
+	for (int k : keys)
+		t.add(k);
+	std::vector<int> sorted(keys);
+	std::sort(sorted.begin(), sorted.end());
+
+	const tree<int>& c = t;
+	std::vector<int> v(t.begin(), t.end());
+	std::vector<int> cv(c.cbegin(), c.cend());
+	std::vector<int> rv(t.rbegin(), t.rend());
+	std::vector<int> crv(c.rbegin(), c.rend());
+	assert(v == sorted && cv == sorted);
+	assert(std::equal(rv.begin(), rv.end(), sorted.rbegin()) && crv == rv);
+	assert(std::distance(t.begin(), t.end()) == static_cast<std::ptrdiff_t>(keys.size()));
+	assert(std::is_sorted(c.cbegin(), c.cend()) && *std::max_element(t.begin(), t.end()) == sorted.back());
+	const std::multiset<int> ref(t.begin(), t.end());
+	assert(sameKeys(t, ref));
+
+	// Through the iterator typedefs.
+	typedef std::iterator_traits<tree<int>::const_iterator> traits;
+	traits::value_type first = *c.cbegin();
+	traits::pointer at = &*c.cbegin();
+	assert(first == sorted.front() && *at == first);
+}
+
+static void testIncrementalRebalance(const std::vector<int>& keys)
+{
+	// Changes interleaved with the slices, duplicates included.
+	tree<int> t;
+	std::multiset<int> ref;
+	std::mt19937 rng(11);
+	for (int k : keys)
+	{
+		t.add(k);
+		ref.insert(k);
+	}
+
+	t.rebalance_start(3);
+	while (t.rebalancing())
+	{
+		int k = static_cast<int>(rng() % 1000);
+		switch (rng() % 3)
+		{
+		case 0:
+			t.add(k);
+			ref.insert(k);
+			break;
+		case 1:
+			assert(t.remove(k) == (ref.count(k) != 0));
+			if (ref.count(k))
+				ref.erase(ref.find(k));
+			break;
+		default:
+			assert(t.search(k) == (ref.count(k) != 0));
+		}
+	}
+	assert(t.size() == ref.size());
+	assert(sameKeys(t, ref));
+
+	// A list of sorted keys, explicit slices only: no slice exceeds its
+	// budget, the result is balanced.
+	const std::size_t budget = 16;
+	tree<int, countingStats> list;
+	for (int k = 0; k < 20000; k++)
+		list.add(k);
+	list.rebalance_start(0);
+	list.policy().reset();
+	while (list.rebalance_step(budget))
+		assert(list.search(0) && !list.search(-1));
+	assert(list.policy().snapshot()[OP_BALANCE].maxDepth <= budget);
+	assert(list.isBalanced() && list.size() == 20000);
+
+	// Rebalances back to back, the tree changed in between, each starting
+	// its copy afresh: the reported repros, then rounds of random changes.
+	{
+		tree<int> grown;
+		for (int k = 1; k <= 10; k++)
+			grown.add(k);
+		grown.rebalance_start(0);
+		while (grown.rebalance_step(4))
+			;
+		for (int k = 11; k <= 20; k++)
+			grown.add(k);
+		grown.rebalance_start(0);
+		while (grown.rebalance_step(4))
+			;
+		assert(grown.size() == 20 && grown.stats().nodes == 20 && grown.search(15));
+
+		tree<int> empty;
+		empty.rebalance_start();
+		empty.add(3);
+		empty.add(2);
+		empty.rebalance_start(1);
+		while (empty.rebalance_step(1))
+			;
+		assert(empty.size() == 2 && empty.search(2) && empty.search(3));
+		assert(sameKeys(empty, std::vector<int>{ 2, 3 }));
+	}
+
+	tree<int> rounds;
+	ref.clear();
+	for (int round = 0; round < 20; round++)
+	{
+		for (int i = 0; i < 200; i++)
+		{
+			int k = static_cast<int>(rng() % 1000);
+			if (rng() % 3)
+			{
+				rounds.add(k);
+				ref.insert(k);
+			}
+			else if (ref.count(k))
+			{
+				assert(rounds.remove(k));
+				ref.erase(ref.find(k));
+			}
+		}
+
+		rounds.rebalance_start(round % 4);
+		while (rounds.rebalance_step(round % 3 + 1))
+		{
+			int k = static_cast<int>(rng() % 1000);
+			if (rng() % 2)
+			{
+				rounds.add(k);
+				ref.insert(k);
+			}
+			else if (ref.count(k))
+			{
+				assert(rounds.remove(k));
+				ref.erase(ref.find(k));
+			}
+		}
+
+		assert(rounds.size() == ref.size() && rounds.stats().nodes == ref.size());
+		assert(sameKeys(rounds, ref));
+		for (int k = -1; k <= 1000; k++)
+			assert(rounds.search(k) == (ref.count(k) != 0));
+	}
+}
+
+static void testSharedTree()
+{
+	// A sorted list rebalanced in the background under a writer and a reader.
+	sharedTree<int> s;
+	std::multiset<int> ref;
+	for (int k = 0; k < 20000; k++)
+	{
+		s.add(k);
+		ref.insert(k);
+	}
+
+	assert(s.rebalanceAsync());
+	std::thread writer([&s]
+	{
+		for (int i = 0; i < 5000; i++)
+		{
+			s.add(20000 + i);
+			if (i % 3 == 0)
+				s.remove(i);
+		}
+	});
+	while (s.rebalancing())
+		assert(s.search(19999));
+	writer.join();
+	s.wait();
+
+	for (int i = 0; i < 5000; i++)
+	{
+		ref.insert(20000 + i);
+		if (i % 3 == 0)
+			ref.erase(ref.find(i));
+	}
+	assert(sameKeys(*s.read(), ref));
+
+	// A view taken before the publish keeps its version.
+	sharedTree<int>::view before = s.read();
+	std::size_t height = before->stats().height;
+	std::uint64_t published = s.versions();
+	assert(s.rebalanceAsync());
+	while (s.versions() == published)
+		std::this_thread::yield();
+	assert(s.read()->isBalanced());
+	assert(before->stats().height == height && sameKeys(*before, ref));
+	{
+		sharedTree<int>::view released = std::move(before);
+	}
+	s.wait();
+}
+
+static void testSet(const std::vector<int>& keys)
+{
+	set<int> s;
+	std::set<int> ref(keys.begin(), keys.end());
+	for (int k : keys)
+		s.insert(k);
+	assert(s.size() == ref.size());
+	assert(sameKeys(s, ref));
+}
+
+static void testMultiset(const std::vector<int>& keys)
+{
+	multiset<int> m;
+	std::multiset<int> ref(keys.begin(), keys.end());
+	for (int k : keys)
+		m.add(k);
+	assert(m.size() == ref.size() && sameKeys(m, ref));
+	assert(m.distinct() == std::set<int>(ref.begin(), ref.end()).size());
+
+	// Collapsed, one entry per key; expanded backwards from end().
+	auto group = ref.begin();
+	for (auto it = m.distinct_begin(); it != m.distinct_end(); ++it, group = ref.upper_bound(*group))
+		assert(it->key == *group && it->count == ref.count(*group));
+	assert(group == ref.end());
+	auto back = ref.rbegin();
+	for (auto it = m.end(); it != m.begin(); ++back)
+		assert(*--it == *back);
+
+	for (std::size_t i = 0; i < keys.size(); i += 2)
+	{
+		std::size_t n = ref.count(keys[i]) ? 1 : 0;
+		assert(m.remove(keys[i]) == n);
+		if (n)
+			ref.erase(ref.find(keys[i]));
+	}
+	m.add(-5, 3);
+	ref.insert({ -5, -5, -5 });
+	assert(m.remove(-5, 10) == 3 && !m.search(-5));
+	ref.erase(-5);
+	for (int k = -1; k <= 1000; k++)
+		assert(m.count(k) == ref.count(k));
+	assert(m.size() == ref.size() && sameKeys(m, ref));
+}
+
+static void testMap(const std::vector<int>& keys)
+{
+	map<int, std::string> m;
+	std::map<int, std::string> ref;
+	for (std::size_t i = 0; i < keys.size(); i++)
+	{
+		std::string v = std::to_string(i);
+		if (i % 4 == 0)
+		{
+			m[keys[i]] += v;
+			ref[keys[i]] += v;
+		}
+		else if (i % 4 == 1)
+			assert(m.try_emplace(keys[i], v).second == ref.emplace(keys[i], v).second);
+		else if (i % 4 == 2)
+			assert(m.insert_or_assign(keys[i], v).second == ref.insert_or_assign(keys[i], v).second);
+		else
+			assert(m.remove(keys[i]) == (ref.erase(keys[i]) != 0));
+	}
+	assert(m.size() == ref.size());
+
+	// In place through find, then entries and lookups agree.
+	for (int k = -1; k <= 1000; k += 7)
+	{
+		auto it = m.find(k);
+		assert((it != m.end()) == (ref.count(k) != 0));
+		if (it != m.end())
+			ref[k] = it->second = "x" + it->second;
+	}
+	auto r = ref.begin();
+	for (auto it = m.begin(); it != m.end(); ++it, ++r)
+		assert(it->first == r->first && it->second == r->second);
+	assert(r == ref.end());
+	const map<int, std::string>& c = m;
+	for (int k = -1; k <= 1000; k++)
+		assert(c.search(k) == (ref.count(k) != 0) && (!c.search(k) || c.at(k) == ref.at(k)));
+
+	// erase returns the next entry.
+	for (auto it = m.begin(); it != m.end(); )
+	{
+		r = ref.erase(ref.find(it->first));
+		it = m.erase(it);
+		assert(r == ref.end() ? it == m.end() : it->first == r->first);
+	}
+	assert(m.empty() && m.begin() == m.end());
+}
+
+// Move-only mapped values, built once and moved into their nodes.
+static void testMoveOnlyMap(const std::vector<int>& keys)
+{
+	map<int, std::unique_ptr<int>> m;
+	std::map<int, int> ref;
+	for (std::size_t i = 0; i < keys.size(); i++)
+	{
+		const int k = keys[i], v = static_cast<int>(i);
+		if (i % 3 == 0)
+			assert(m.try_emplace(k, std::unique_ptr<int>(new int(v))).second == ref.emplace(k, v).second);
+		else if (i % 3 == 1)
+		{
+			ref[k] = v;
+			assert(m.insert_or_assign(k, std::unique_ptr<int>(new int(v))).first->second);
+		}
+		else if (!m[k])
+			m[k].reset(new int(ref[k] = v));
+	}
+	assert(m.size() == ref.size());
+
+	auto r = ref.begin();
+	for (auto it = m.begin(); it != m.end(); ++it, ++r)
+		assert(it->first == r->first && *it->second == r->second);
+	assert(r == ref.end());
+
+	// The pointer stored is the one passed in, never a copy.
+	int* raw = new int(-1);
+	assert(m.try_emplace(-1, raw).second && m.at(-1).get() == raw);
+	std::unique_ptr<int> kept(new int(-2));
+	assert(!m.try_emplace(-1, std::move(kept)).second && kept && m.at(-1).get() == raw);
+	ref[-1] = -1;
+
+	// Removal moves a successor's value into the erased entry's node.
+	for (std::size_t i = 0; i < keys.size(); i += 2)
+		assert(m.remove(keys[i]) == (ref.erase(keys[i]) != 0));
+	r = ref.begin();
+	for (auto it = m.begin(); it != m.end(); ++it, ++r)
+		assert(it->first == r->first && *it->second == r->second);
+	assert(r == ref.end());
+}
+
+static void testSequences(const std::vector<int>& keys)
+{
+	Stack<int> s;
+	std::stack<int> refStack;
+	for (int k : keys)
+	{
+		s.push(k);
+		refStack.push(k);
+	}
+	for (; !refStack.empty(); refStack.pop())
+		assert(s.pop() == refStack.top());
+	assert(s.empty());
+
+	Queue<int, 17> q;
+	std::deque<int> refQueue;
+	for (int k : keys)
+	{
+		if (q.isFull())
+		{
+			assert(q.front() == refQueue.front());
+			q.dequeue();
+			refQueue.pop_front();
+		}
+		q.enqueue(k);
+		refQueue.push_back(k);
+		assert(q.back() == refQueue.back());
+	}
+	for (; !refQueue.empty(); refQueue.pop_front())
+	{
+		assert(q.front() == refQueue.front());
+		q.dequeue();
+	}
+	assert(q.empty());
+
+	Vector<int> v;
+	std::vector<int> refVector;
+	for (int k : keys)
+	{
+		v.push_back(k);
+		refVector.push_back(k);
+	}
+	assert(v.size() == refVector.size());
+	for (std::size_t i = 0; i < refVector.size(); i++)
+		assert(v[i] == refVector[i]);
+
+	myList::list<int> l;
+	std::forward_list<int> refList(keys.begin(), keys.end());
+	for (int k : keys)
+		l.add(k);
+	auto it = l.begin();
+	for (int k : refList)
+	{
+		assert(it != l.end() && *it == k);
+		++it;
+	}
+	assert(it == l.end());
+	for (int k = -1; k <= 1000; k++)
+		assert((l.find(k) != nullptr) == (std::find(refList.begin(), refList.end(), k) != refList.end()));
+}
+
+int main()
+{
+	std::mt19937 rng(7);
+	std::vector<int> keys;
+	for (int i = 0; i < 5000; i++)
+		keys.push_back(static_cast<int>(rng() % 1000));
+
+	testTree(keys);
+	testTreeWithParent(keys);
+	testSortedTrees();
+	testAutoBalance();
+	testTreeIterators(keys);
+	testNoDefault(keys);
+	testIteratorRanges(keys);
+	testIncrementalRebalance(keys);
+	testSharedTree();
+	testSet(keys);
+	testMultiset(keys);
+	testMap(keys);
+	testMoveOnlyMap(keys);
+	testSequences(keys);
+	return 0;
+}
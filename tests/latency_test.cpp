@@ -0,0 +1,179 @@
+/*************************************************************************
+* Title: Latency Histogram Test
+* File: latency_test.cpp
+* Date: 10/18/2026
+*
+* Checks latencyHistogram: exact values below 64, values on both sides
+* of every bucket boundary, percentiles never below the true value and
+* within 1/32 above it, count, min, max, mean and merge against the
+* recorded values, values from 2^48 up sharing the overflow bucket, and
+* a latencyStats tree timing each operation once under its type. Exits
+* non-zero on failure.
+*************************************************************************/
+#undef NDEBUG // Checks below must run in every build type.
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "../latency.h"
+#include "../tree_with_parent.h"
+
+// The p-th percentile of sorted values by the histogram's rank rule.
+static std::uint64_t truePercentile(const std::vector<std::uint64_t>& sorted, double p)
+{
+	double want = std::ceil(p / 100.0 * sorted.size());
+	std::size_t rank = want < 1.0 ? 1 : want >= sorted.size() ? sorted.size() : static_cast<std::size_t>(want);
+	return sorted[rank - 1];
+}
+
+static const double PERCENTILES[] = { 0.0, 1.0, 10.0, 25.0, 50.0, 75.0, 90.0, 99.0, 99.9, 99.99, 100.0 };
+
+static void testEmpty()
+{
+	latencyHistogram h;
+	assert(h.count() == 0 && h.min() == 0 && h.max() == 0 && h.mean() == 0.0);
+	assert(h.percentile(0) == 0 && h.percentile(50) == 0 && h.percentile(100) == 0);
+}
+
+static void testExact()
+{
+	// One of each value below 64, each its own bucket.
+	latencyHistogram h;
+	for (std::uint64_t v = 0; v < 64; v++)
+		h.record(v);
+	assert(h.count() == 64 && h.min() == 0 && h.max() == 63 && h.mean() == 31.5);
+	for (std::uint64_t rank = 1; rank <= 64; rank++)
+		assert(h.percentile((rank - 0.5) * 100.0 / 64) == rank - 1);
+}
+
+static void testBoundaries()
+{
+	// Buckets above 64 start at k << e, 32 <= k < 64, and are 2^e wide. The
+	// value before a start is the previous bucket's upper bound, reported
+	// as is, a start reports the upper bound of its own bucket.
+	for (int e = 1; e <= 42; e++)
+		for (std::uint64_t k = 32; k < 64; k++)
+		{
+			const std::uint64_t start = k << e, last = start + (std::uint64_t(1) << e) - 1;
+
+			latencyHistogram below;
+			below.record(start - 1);
+			below.record(last);
+			assert(below.percentile(1) == start - 1 && below.percentile(100) == last);
+
+			latencyHistogram at;
+			at.record(start);
+			at.record(last);
+			at.record(last + 1);
+			assert(at.percentile(1) == last && at.percentile(60) == last && at.percentile(100) == last + 1);
+		}
+}
+
+static void testPrecision()
+{
+	// Log-uniform values up to 2^48, so every exponent is covered.
+	std::mt19937_64 rng(1);
+	for (int round = 0; round < 20; round++)
+	{
+		latencyHistogram h;
+		std::vector<std::uint64_t> values;
+		for (int i = 0; i < 5000; i++)
+		{
+			std::uint64_t v = rng() >> (16 + rng() % 48);
+			values.push_back(v);
+			h.record(v);
+		}
+		std::sort(values.begin(), values.end());
+
+		for (double p : PERCENTILES)
+		{
+			std::uint64_t want = truePercentile(values, p), got = h.percentile(p);
+			assert(got >= want && got - want <= want / 32);
+		}
+		assert(h.percentile(0) == values.front() && h.percentile(100) == values.back());
+	}
+}
+
+static void testMerge()
+{
+	std::mt19937_64 rng(2);
+	latencyHistogram a, b, all, none;
+	std::vector<std::uint64_t> values;
+	std::uint64_t sum = 0;
+
+	for (int i = 0; i < 20000; i++)
+	{
+		std::uint64_t v = rng() >> (20 + rng() % 44);
+		(i % 3 ? a : b).record(v);
+		all.record(v);
+		values.push_back(v);
+		sum += v;
+	}
+	std::sort(values.begin(), values.end());
+
+	latencyHistogram merged = a;
+	merged.merge(b);
+	merged.merge(none);
+	assert(merged.count() == values.size() && merged.count() == a.count() + b.count());
+	assert(merged.min() == values.front() && merged.max() == values.back());
+	assert(merged.mean() == static_cast<double>(sum) / values.size());
+	for (double p : PERCENTILES)
+		assert(merged.percentile(p) == all.percentile(p));
+
+	// Into an empty histogram, and clear back to empty.
+	none.merge(merged);
+	assert(none.count() == merged.count() && none.min() == merged.min() && none.max() == merged.max());
+	assert(none.percentile(50) == merged.percentile(50));
+	none.clear();
+	assert(none.count() == 0 && none.min() == 0 && none.max() == 0 && none.percentile(50) == 0);
+}
+
+static void testOverflow()
+{
+	// From 2^48 up values share one bucket, reported as the largest.
+	const std::uint64_t top = std::uint64_t(1) << 48;
+	latencyHistogram h;
+	h.record(top);
+	h.record(top << 10);
+	h.record(~std::uint64_t(0));
+	assert(h.percentile(1) == ~std::uint64_t(0) && h.min() == top && h.max() == ~std::uint64_t(0));
+
+	// The last bucket below keeps its precision next to them.
+	latencyHistogram g;
+	g.record(top - 1);
+	g.record(top << 4);
+	assert(g.percentile(1) == top - 1 && g.percentile(100) == top << 4);
+}
+
+static void testTreeOps()
+{
+	tree<int, latencyStats> t;
+	for (int k = 0; k < 100; k++)
+		t.add(k);
+	t.search(5);
+	latencySnapshot s = t.policy().snapshot();
+	assert(s[OP_ADD].count() == 100 && s[OP_SEARCH].count() == 1 && s[OP_BEGIN].count() == 0);
+
+	// Every end as well as every begin is positioning, each step iterating.
+	t.policy().reset();
+	const tree<int, latencyStats>& c = t;
+	assert(t.begin() != t.end() && t.rbegin() != t.rend());
+	assert(c.cbegin() != c.cend() && c.rbegin() != c.rend());
+	tree<int, latencyStats>::iterator it = t.end();
+	--it;
+	s = t.policy().snapshot();
+	assert(s[OP_BEGIN].count() == 9 && s[OP_ITERATE].count() == 1 && s[OP_ADD].count() == 0);
+}
+
+int main()
+{
+	testEmpty();
+	testExact();
+	testBoundaries();
+	testPrecision();
+	testMerge();
+	testOverflow();
+	testTreeOps();
+	return 0;
+}
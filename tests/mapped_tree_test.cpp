@@ -0,0 +1,83 @@
+/*************************************************************************
+* Title: Memory Mapped Tree Test
+* File: mapped_tree_test.cpp
+* Date: 10/18/2026
+*
+* Builds a mapped tree file, closes it, reopens it read-only and checks
+* the keys iterate back in sorted order. Exits non-zero on failure.
+*************************************************************************/
+#undef NDEBUG // Checks below must run in every build type.
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../mapped_tree.h"
+
+int main(int argc, char* argv[])
+{
+	const std::string path = argc > 1 ? argv[1] : "mapped_tree_test.bin";
+	const int n = 100000;
+
+	std::vector<int> keys;
+	std::mt19937 rng(1);
+	for (int i = 0; i < n; i++)
+		keys.push_back(static_cast<int>(rng() % (n / 2)));
+
+	// Small initial capacity, so the file is grown (and remapped) often.
+	{
+		mappedTree<int> t;
+		t.create(path, 16);
+		for (int k : keys)
+			t.add(k);
+		assert(t.size() == keys.size());
+		t.balance();
+		t.sync();
+	}
+
+	std::sort(keys.begin(), keys.end());
+
+	mappedTree<int> t;
+	t.open(path);
+	assert(t.size() == keys.size());
+
+	// Forward and reverse iteration order.
+	std::size_t i = 0;
+	for (mappedTree<int>::iterator it = t.begin(); it != t.end(); ++it)
+		assert(*it == keys[i++]);
+	assert(i == keys.size());
+
+	for (mappedTree<int>::iterator it = t.end(); it != t.begin(); )
+		assert(*--it == keys[--i]);
+	assert(i == 0);
+
+	assert(t.search(keys.front()) && t.search(keys.back()));
+	assert(!t.search(-1) && !t.search(n));
+	assert(t.getHeight() <= 32);
+
+	// Read-only mappings reject writes.
+	bool threw = false;
+	try { t.add(1); }
+	catch (const std::logic_error&) { threw = true; }
+	assert(threw);
+
+	// Reopen writable, append and check order again.
+	t.open(path, false);
+	t.add(n);
+	t.add(-1);
+	assert(*t.begin() == -1 && *--t.end() == n);
+	assert(t.size() == keys.size() + 2);
+	t.close();
+
+	// Files of another key type are rejected.
+	threw = false;
+	try { mappedTree<double> d; d.open(path); }
+	catch (const std::runtime_error&) { threw = true; }
+	assert(threw);
+
+	std::remove(path.c_str());
+	std::puts("mapped_tree_test passed.");
+	return 0;
+}
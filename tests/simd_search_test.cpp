@@ -0,0 +1,159 @@
+/*************************************************************************
+* Title: SIMD Search Test
+* File: simd_search_test.cpp
+* Date: 10/18/2026
+*
+* Checks simd::lowerBound and upperBound for every vectorized key type
+* against std::lower_bound and std::upper_bound, on sorted arrays of
+* every length up to twice LINEAR_MAX (the scanned and the bisected
+* paths), built from keys at the signed and unsigned extremes with runs
+* of duplicates, at an unaligned start. The byte16 node searches are
+* checked against their scalar meaning. Exits non-zero on failure.
+*************************************************************************/
+#undef NDEBUG // Checks below must run in every build type.
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+#include "../simd_search.h"
+
+// Keys every test array draws from: both ends of the range, either side
+// of zero, and the sign boundary of the unsigned types.
+template <class T>
+static std::vector<T> interesting()
+{
+	typedef std::numeric_limits<T> limits;
+	std::vector<T> v = {
+		limits::lowest(), static_cast<T>(limits::lowest() + 1), static_cast<T>(0), static_cast<T>(1),
+		static_cast<T>(limits::max() - 1), limits::max(), static_cast<T>(limits::max() / 2),
+		static_cast<T>(limits::max() / 2 + 1)
+	};
+	if (limits::is_signed)
+	{
+		v.push_back(static_cast<T>(-1));
+		v.push_back(static_cast<T>(-2));
+	}
+	return v;
+}
+
+template <class T>
+static void testType(unsigned seed)
+{
+	const std::vector<T> pool = interesting<T>();
+	std::mt19937 rng(seed);
+
+	for (std::size_t n = 0; n <= 2 * simd::LINEAR_MAX + 1; n++)
+	{
+		for (int round = 0; round < 20; round++)
+		{
+			// One spare slot in front, so the keys start unaligned.
+			std::vector<T> storage(n + 1);
+			for (std::size_t i = 1; i <= n; i++)
+				storage[i] = pool[rng() % pool.size()];
+			std::sort(storage.begin() + 1, storage.end());
+
+			const T* first = storage.data() + 1;
+			const T* last = first + n;
+
+			for (const T& key : pool)
+			{
+				assert(simd::lowerBound(first, last, key) == std::lower_bound(first, last, key));
+				assert(simd::upperBound(first, last, key) == std::upper_bound(first, last, key));
+			}
+		}
+	}
+
+	// Every value of the narrow types against a full ascending array.
+	if (sizeof(T) == 1)
+	{
+		std::vector<T> all;
+		for (int i = std::numeric_limits<T>::lowest(); i <= std::numeric_limits<T>::max(); i++)
+			all.push_back(static_cast<T>(i));
+
+		const T* first = all.data();
+		const T* last = first + all.size();
+		for (const T& key : all)
+		{
+			assert(simd::lowerBound(first, last, key) == std::lower_bound(first, last, key));
+			assert(simd::upperBound(first, last, key) == std::upper_bound(first, last, key));
+		}
+	}
+}
+
+template <class T>
+static void testFloating()
+{
+	typedef std::numeric_limits<T> limits;
+	const std::vector<T> pool = {
+		limits::lowest(), -limits::infinity(), limits::infinity(), static_cast<T>(-1), static_cast<T>(-0.0),
+		static_cast<T>(0), limits::denorm_min(), limits::min(), static_cast<T>(0.5), limits::max()
+	};
+	std::mt19937 rng(9);
+
+	for (std::size_t n = 0; n <= 2 * simd::LINEAR_MAX + 1; n++)
+	{
+		std::vector<T> storage(n + 1);
+		for (std::size_t i = 1; i <= n; i++)
+			storage[i] = pool[rng() % pool.size()];
+		std::sort(storage.begin() + 1, storage.end());
+
+		const T* first = storage.data() + 1;
+		const T* last = first + n;
+		for (const T& key : pool)
+		{
+			assert(simd::lowerBound(first, last, key) == std::lower_bound(first, last, key));
+			assert(simd::upperBound(first, last, key) == std::upper_bound(first, last, key));
+		}
+	}
+}
+
+// Node key bytes: sorted for lowerBoundByte16, garbage past n that must
+// be ignored.
+static void testByte16()
+{
+	std::mt19937 rng(11);
+
+	for (unsigned n = 0; n <= 16; n++)
+	{
+		for (int round = 0; round < 50; round++)
+		{
+			unsigned char keys[16];
+			for (unsigned char& k : keys)
+				k = static_cast<unsigned char>(rng());
+			std::sort(keys, keys + n);
+			if (n && round % 2)
+			{
+				keys[0] = 0;
+				keys[n - 1] = 0xFF;
+			}
+
+			for (int b = 0; b < 256; b++)
+			{
+				const unsigned char c = static_cast<unsigned char>(b);
+				assert(simd::lowerBoundByte16(keys, n, c) == static_cast<unsigned>(std::lower_bound(keys, keys + n, c) - keys));
+
+				const unsigned char* at = std::find(keys, keys + n, c);
+				assert(simd::findByte16(keys, n, c) == (at == keys + n ? -1 : static_cast<int>(at - keys)));
+			}
+		}
+	}
+}
+
+int main()
+{
+	testType<std::int8_t>(1);
+	testType<std::uint8_t>(2);
+	testType<char>(3);
+	testType<std::int16_t>(4);
+	testType<std::uint16_t>(5);
+	testType<std::int32_t>(6);
+	testType<std::uint32_t>(7);
+	testType<std::int64_t>(8);
+	testType<std::uint64_t>(9);
+	testFloating<float>();
+	testFloating<double>();
+	testByte16();
+	return 0;
+}
@@ -0,0 +1,162 @@
+/*************************************************************************
+* Title: String Key Tree Test
+* File: string_tree_test.cpp
+* Date: 10/18/2026
+*
+* Checks stringTree and frozenStrings against std::set<std::string> on
+* keys that share or differ within and past the first 8 bytes (the
+* node's integer prefix), keys that are prefixes of one another, embedded
+* and trailing NULs, bytes above 0x7F, empty strings and duplicates.
+* Search and iteration are compared before and after balance(), on the
+* frozen snapshot, and on a frozenStrings built from the set. Exits
+* non-zero on failure.
+*************************************************************************/
+#undef NDEBUG // Checks below must run in every build type.
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+#include "../string_tree.h"
+
+static std::vector<std::string> makeKeys()
+{
+	const std::string stems[] = {
+		"", "a", "abcdefg", "abcdefgh", "abcdefghi", "abcdefgh\xFF", "abcdefgi",
+		std::string("abc\0efgh", 8), std::string("abcdefgh\0", 9), std::string("\0", 1),
+		std::string("\0\0\0\0\0\0\0\0\0", 9), "\x80\x80", "\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF",
+		"http://example.com/", "http://example.com/index.html"
+	};
+
+	std::vector<std::string> keys;
+	std::mt19937 rng(1);
+	for (const std::string& s : stems)
+	{
+		keys.push_back(s);
+		keys.push_back(s + std::string(1, '\0'));
+		for (int i = 0; i < 40; i++)
+		{
+			// Differing in the byte after the stem, and further on.
+			keys.push_back(s + static_cast<char>(rng()));
+			keys.push_back(s + std::to_string(rng() % 1000));
+			keys.push_back(s + std::string(rng() % 12, static_cast<char>(rng() % 3)) + static_cast<char>(rng()));
+		}
+	}
+
+	// Duplicates, the stems and a sample of the rest added again.
+	const std::size_t n = keys.size();
+	for (std::size_t i = 0; i < n; i += 7)
+		keys.push_back(keys[i]);
+	std::shuffle(keys.begin(), keys.end(), rng);
+	return keys;
+}
+
+// Probes present and absent: every key, and each with a byte appended
+// or removed.
+static std::vector<std::string> makeProbes(const std::vector<std::string>& keys)
+{
+	std::vector<std::string> probes;
+	for (const std::string& k : keys)
+	{
+		probes.push_back(k);
+		probes.push_back(k + '\x01');
+		probes.push_back(k + '\0');
+		if (!k.empty())
+			probes.push_back(k.substr(0, k.size() - 1));
+	}
+	return probes;
+}
+
+template <class S>
+static void checkSearch(const S& s, const std::set<std::string>& ref, const std::vector<std::string>& probes)
+{
+	for (const std::string& p : probes)
+	{
+		assert(s.search(p) == (ref.count(p) != 0));
+		assert(s.search(p.data(), p.size()) == (ref.count(p) != 0));
+	}
+}
+
+template <class It, class RefIt>
+static void checkOrder(It first, It last, RefIt expected, RefIt end)
+{
+	for (; first != last; ++first, ++expected)
+		assert(expected != end && *first == *expected);
+	assert(expected == end);
+}
+
+static void testTree(const std::vector<std::string>& keys, const std::vector<std::string>& probes)
+{
+	std::set<std::string> ref;
+	std::multiset<std::string> all;
+	stringTree t;
+
+	assert(t.empty() && t.begin() == t.end() && !t.search(""));
+
+	for (std::size_t i = 0; i < keys.size(); i++)
+	{
+		t.add(keys[i]);
+		ref.insert(keys[i]);
+		all.insert(keys[i]);
+		if (i % 256 == 0)
+			checkSearch(t, ref, probes);
+	}
+
+	// add() keeps duplicates, iteration repeats them.
+	assert(t.size() == keys.size());
+	checkSearch(t, ref, probes);
+	checkOrder(t.begin(), t.end(), all.begin(), all.end());
+
+	const int height = t.getHeight();
+	t.balance();
+	assert(t.size() == keys.size() && t.getHeight() <= height);
+	checkSearch(t, ref, probes);
+	checkOrder(t.begin(), t.end(), all.begin(), all.end());
+
+	// The snapshot holds the keys in tree order, duplicates included.
+	frozenStrings f = t.freeze();
+	assert(f.size() == keys.size() && f.bytes() > 0);
+	checkSearch(f, ref, probes);
+	checkOrder(f.begin(), f.end(), all.begin(), all.end());
+
+	t.clear();
+	assert(t.empty() && t.size() == 0 && t.begin() == t.end() && !t.search(keys[0]));
+}
+
+static void testFrozen(const std::vector<std::string>& keys, const std::vector<std::string>& probes)
+{
+	const std::set<std::string> ref(keys.begin(), keys.end());
+
+	frozenStrings none;
+	assert(none.empty() && none.begin() == none.end() && !none.search(""));
+
+	// Every size around a block boundary, then the whole set.
+	for (std::size_t n = 1; n <= 2 * frozenStrings::BLOCK + 1; n++)
+	{
+		std::set<std::string>::const_iterator last = ref.begin();
+		std::advance(last, n);
+		const std::set<std::string> part(ref.begin(), last);
+
+		frozenStrings f(part.begin(), part.end());
+		assert(f.size() == n);
+		checkSearch(f, part, probes);
+		checkOrder(f.begin(), f.end(), part.begin(), part.end());
+	}
+
+	frozenStrings f(ref.begin(), ref.end());
+	assert(f.size() == ref.size());
+	checkSearch(f, ref, probes);
+	checkOrder(f.begin(), f.end(), ref.begin(), ref.end());
+}
+
+int main()
+{
+	const std::vector<std::string> keys = makeKeys();
+	const std::vector<std::string> probes = makeProbes(keys);
+
+	testTree(keys, probes);
+	testFrozen(keys, probes);
+	return 0;
+}
@@ -0,0 +1,220 @@
+/*************************************************************************
+* Title: Tree Loader Test
+* File: tree_loader_test.cpp
+* Date: 10/18/2026
+*
+* Loads text and binary key files into tree<T> and checks the keys land
+* in order against std::multiset: CRLF and mixed delimiters, tokens cut
+* by the read buffer, sorted and unsorted runs switching the batcher
+* between growing and flushing, bad tokens reported with their line, and
+* truncated binary records. Exits non-zero on failure.
+*************************************************************************/
+#undef NDEBUG // Checks below must run in every build type.
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../tree_loader.h"
+
+template <class T, class C>
+static void checkKeys(const tree<T>& t, const C& expected)
+{
+	std::multiset<T> ref(expected.begin(), expected.end());
+	assert(t.size() == ref.size());
+
+	typename std::multiset<T>::const_iterator at = ref.begin();
+	for (typename tree<T>::const_iterator it = t.cbegin(); it != t.cend(); ++it, ++at)
+		assert(at != ref.end() && *it == *at);
+	assert(at == ref.end());
+}
+
+template <class T>
+static std::size_t loadText(tree<T>& t, const std::string& text, std::size_t batch = loader::BATCH)
+{
+	std::istringstream is(text);
+	return loader::text(t, is, batch);
+}
+
+// The error message of a load expected to fail, empty if it loaded.
+template <class T>
+static std::string loadError(const std::string& text)
+{
+	tree<T> t;
+	try
+	{
+		loadText(t, text);
+	}
+	catch (const std::runtime_error& e)
+	{
+		return e.what();
+	}
+	return std::string();
+}
+
+static void testDelimiters()
+{
+	// Numbers split on any whitespace, CRLF included.
+	tree<int> n;
+	assert(loadText(n, "3 1\r\n-7\t2\r\n\r\n\v5\f 0\n\n 4 \r\n9") == 8);
+	checkKeys(n, std::vector<int>{ 3, 1, -7, 2, 5, 0, 4, 9 });
+
+	tree<double> d;
+	assert(loadText(d, "1.5\r\n-2e3 0.25\r\n") == 3);
+	checkKeys(d, std::vector<double>{ 1.5, -2e3, 0.25 });
+
+	// Strings split on newlines only, keeping inner spaces, with the CR of
+	// a CRLF ending dropped and blank lines skipped either way.
+	tree<std::string> s;
+	assert(loadText(s, "pear\r\nan apple\r\n\r\n\tfig \nkiwi\n\ndate") == 5);
+	checkKeys(s, std::vector<std::string>{ "pear", "an apple", "\tfig ", "kiwi", "date" });
+
+	// Empty input and input of delimiters only.
+	tree<int> e;
+	assert(loadText(e, "") == 0 && loadText(e, " \r\n\r\n\t") == 0 && e.empty());
+}
+
+static void testBatching()
+{
+	// Sorted input grows one batch however small the batch size, so it is
+	// built as one balanced tree.
+	std::vector<int> sorted;
+	for (int i = 0; i < 5000; i++)
+		sorted.push_back(i / 3);
+
+	std::string text;
+	for (int k : sorted)
+		text += std::to_string(k) + "\r\n";
+
+	tree<int> a;
+	assert(loadText(a, text, 16) == sorted.size());
+	checkKeys(a, sorted);
+	assert(a.stats().height == a.stats().optimalHeight());
+
+	// Sorted runs broken by descents, each flushing a batch, and shuffled
+	// keys flushing every batch as it fills, at several batch sizes.
+	std::vector<int> runs;
+	std::mt19937 rng(1);
+	for (int r = 0; r < 40; r++)
+	{
+		int from = static_cast<int>(rng() % 10000) - 5000;
+		for (int i = 0, n = static_cast<int>(rng() % 200); i < n; i++)
+			runs.push_back(from + i);
+	}
+	std::vector<int> shuffled = sorted;
+	std::shuffle(shuffled.begin(), shuffled.end(), rng);
+
+	for (const std::vector<int>* keys : { &runs, &shuffled })
+	{
+		std::string mixed;
+		for (std::size_t i = 0; i < keys->size(); i++)
+			mixed += std::to_string((*keys)[i]) + (i % 3 == 0 ? " " : i % 3 == 1 ? "\t" : "\r\n");
+
+		for (std::size_t batch : { std::size_t(0), std::size_t(1), std::size_t(7), std::size_t(256), loader::BATCH })
+		{
+			tree<int> t;
+			assert(loadText(t, mixed, batch) == keys->size());
+			checkKeys(t, *keys);
+		}
+	}
+
+	// Loading into a tree that already holds keys merges with them.
+	tree<int> b;
+	loadText(b, "100 200 300");
+	assert(loadText(b, "150 50 250\r\n350", 2) == 4);
+	checkKeys(b, std::vector<int>{ 50, 100, 150, 200, 250, 300, 350 });
+}
+
+static void testBufferBoundaries()
+{
+	// More than one read buffer of text, so tokens are cut by reads, and
+	// a string line longer than the buffer, which grows it.
+	std::vector<std::int64_t> keys;
+	std::string text;
+	std::mt19937_64 rng(2);
+	while (text.size() < 3 * loader::BUFFER)
+	{
+		keys.push_back(static_cast<std::int64_t>(rng()));
+		text += std::to_string(keys.back()) + (keys.size() % 2 ? "\r\n" : " ");
+	}
+
+	tree<std::int64_t> t;
+	assert(loadText(t, text) == keys.size());
+	checkKeys(t, keys);
+
+	const std::string longLine(loader::BUFFER + 12345, 'x');
+	tree<std::string> s;
+	assert(loadText(s, "b\r\n" + longLine + "\r\na") == 3);
+	checkKeys(s, std::vector<std::string>{ "b", longLine, "a" });
+}
+
+static void testBadTokens()
+{
+	const std::string line2 = "loader::text: bad key at line 2";
+	assert(loadError<int>("1 2\r\n3 x4\r\n5") == line2);
+	assert(loadError<int>("1\n\n\n9999999999\n") == "loader::text: bad key at line 4");
+	assert(loadError<int>("1\r\n2.5") == line2);
+	assert(loadError<int>("0x10") == "loader::text: bad key at line 1");
+	assert(loadError<unsigned>("5\n-1") == line2);
+	assert(loadError<double>("1.0\r\n1.0.0") == line2);
+	assert(loadError<double>("1e5 1e\n") == "loader::text: bad key at line 1");
+	assert(loadError<int>("1 2\r\n3") == std::string());
+
+	// The line counts across read buffers.
+	std::string text;
+	for (std::size_t i = 0; text.size() < 2 * loader::BUFFER; i++)
+		text += "12345\r\n";
+	const std::size_t lines = std::count(text.begin(), text.end(), '\n');
+	assert(loadError<int>(text + "12a45\r\n") == "loader::text: bad key at line " + std::to_string(lines + 1));
+}
+
+static void testBinary()
+{
+	std::vector<std::uint32_t> keys;
+	std::mt19937 rng(3);
+	for (std::size_t i = 0; i < loader::BUFFER / sizeof(std::uint32_t) * 2 + 77; i++)
+		keys.push_back(i % 1000 < 900 ? static_cast<std::uint32_t>(i) : rng());
+
+	const std::string bytes(reinterpret_cast<const char*>(keys.data()), keys.size() * sizeof(std::uint32_t));
+	for (std::size_t batch : { std::size_t(5), loader::BATCH })
+	{
+		tree<std::uint32_t> t;
+		std::istringstream is(bytes);
+		assert(loader::binary(t, is, batch) == keys.size());
+		checkKeys(t, keys);
+	}
+
+	tree<std::uint32_t> e;
+	std::istringstream none("");
+	assert(loader::binary(e, none) == 0 && e.empty());
+
+	// A record cut short, in the first read and past several.
+	for (std::size_t size : { std::size_t(3), bytes.size() - 1, bytes.size() - 2 * sizeof(std::uint32_t) + 1 })
+	{
+		tree<std::uint32_t> t;
+		std::istringstream is(bytes.substr(0, size));
+		try
+		{
+			loader::binary(t, is);
+			assert(!"truncated record loaded");
+		}
+		catch (const std::runtime_error& e)
+		{
+			assert(std::string(e.what()) == "loader::binary: truncated record");
+		}
+	}
+}
+
+int main()
+{
+	testDelimiters();
+	testBatching();
+	testBufferBoundaries();
+	testBadTokens();
+	testBinary();
+	return 0;
+}
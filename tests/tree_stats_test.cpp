@@ -0,0 +1,144 @@
+/*************************************************************************
+* Title: Tree Shape Statistics Test
+* File: tree_stats_test.cpp
+* Date: 10/18/2026
+*
+* Measures trees of known shape and compares the JSON and Prometheus
+* exports, label escaping included, with the exact expected text. Exits
+* non-zero on failure.
+*************************************************************************/
+#undef NDEBUG // Checks below must run in every build type.
+#include <cassert>
+#include <sstream>
+#include <string>
+#include "../tree.h"
+#include "../tree_stats.h"
+#include "../tree_with_parent.h"
+
+// Depths 1, 2, 4, 1: 4 over 2 and 6 over 1, 3, 5 and 7, 7 over 8.
+static const int SHAPE[] = { 4, 2, 6, 1, 3, 5, 7, 8 };
+
+static void testShape()
+{
+	tree<int> t;
+	Tree<int> u;
+	for (int k : SHAPE)
+	{
+		t.add(k);
+		u.add(k);
+	}
+
+	for (const treeStats& s : { t.stats(), u.stats() })
+	{
+		assert(s.nodes == 8 && s.leaves == 4 && s.height == 4 && s.totalDepth == 13);
+		assert(s.depths.size() == 4 && s.depths[0] == 1 && s.depths[1] == 2 && s.depths[2] == 4 && s.depths[3] == 1);
+		assert(s.optimalHeight() == 4 && s.heightRatio() == 1.0 && s.meanPath() == 2.625 && s.maxPath() == 4);
+	}
+}
+
+static void testJson()
+{
+	tree<int> t;
+	for (int k : SHAPE)
+		t.add(k);
+
+	std::ostringstream os;
+	writeJson(os, t.stats());
+	assert(os.str() ==
+		"{ \"nodes\": 8, \"leaves\": 4, \"height\": 4, \"optimal_height\": 4, \"height_ratio\": 1,"
+		" \"mean_path\": 2.625, \"max_path\": 4, \"depths\": [1, 2, 4, 1] }");
+
+	// A chain of 3: height 3 over 2.
+	tree<int> chain;
+	for (int k = 0; k < 3; k++)
+		chain.add(k);
+	std::ostringstream cs;
+	writeJson(cs, chain.stats());
+	assert(cs.str() ==
+		"{ \"nodes\": 3, \"leaves\": 1, \"height\": 3, \"optimal_height\": 2, \"height_ratio\": 1.5,"
+		" \"mean_path\": 2, \"max_path\": 3, \"depths\": [1, 1, 1] }");
+
+	std::ostringstream es;
+	writeJson(es, tree<int>().stats());
+	assert(es.str() ==
+		"{ \"nodes\": 0, \"leaves\": 0, \"height\": 0, \"optimal_height\": 0, \"height_ratio\": 0,"
+		" \"mean_path\": 0, \"max_path\": 0, \"depths\": [] }");
+}
+
+static void testPrometheus()
+{
+	tree<int> t;
+	for (int k : SHAPE)
+		t.add(k);
+
+	// Backslash, double quote and newline in a label value are escaped.
+	std::ostringstream os;
+	writePrometheus(os, t.stats(), "orders", { { "shard", "a\"b\\c\nd" }, { "env", "prod" } });
+	const std::string l = "{shard=\"a\\\"b\\\\c\\nd\",env=\"prod\"}";
+	assert(os.str() ==
+		"# HELP orders_nodes Number of nodes.\n"
+		"# TYPE orders_nodes gauge\n"
+		"orders_nodes" + l + " 8\n"
+		"# HELP orders_leaves Number of leaf nodes.\n"
+		"# TYPE orders_leaves gauge\n"
+		"orders_leaves" + l + " 4\n"
+		"# HELP orders_height Levels of the tree.\n"
+		"# TYPE orders_height gauge\n"
+		"orders_height" + l + " 4\n"
+		"# HELP orders_height_ratio Height over the least possible height, 1 is perfectly balanced.\n"
+		"# TYPE orders_height_ratio gauge\n"
+		"orders_height_ratio" + l + " 1\n"
+		"# HELP orders_mean_search_path Mean comparisons to find a present key.\n"
+		"# TYPE orders_mean_search_path gauge\n"
+		"orders_mean_search_path" + l + " 2.625\n"
+		"# HELP orders_max_search_path Comparisons to find the deepest key.\n"
+		"# TYPE orders_max_search_path gauge\n"
+		"orders_max_search_path" + l + " 4\n"
+		"# HELP orders_node_depth Depth of each node, root at 0.\n"
+		"# TYPE orders_node_depth histogram\n"
+		"orders_node_depth_bucket{shard=\"a\\\"b\\\\c\\nd\",env=\"prod\",le=\"1\"} 3\n"
+		"orders_node_depth_bucket{shard=\"a\\\"b\\\\c\\nd\",env=\"prod\",le=\"2\"} 7\n"
+		"orders_node_depth_bucket{shard=\"a\\\"b\\\\c\\nd\",env=\"prod\",le=\"4\"} 8\n"
+		"orders_node_depth_bucket{shard=\"a\\\"b\\\\c\\nd\",env=\"prod\",le=\"+Inf\"} 8\n"
+		"orders_node_depth_sum" + l + " 13\n"
+		"orders_node_depth_count" + l + " 8\n");
+
+	// No labels, no braces on the gauges, only le on the buckets.
+	std::ostringstream es;
+	writePrometheus(es, tree<int>().stats());
+	assert(es.str() ==
+		"# HELP tree_nodes Number of nodes.\n"
+		"# TYPE tree_nodes gauge\n"
+		"tree_nodes 0\n"
+		"# HELP tree_leaves Number of leaf nodes.\n"
+		"# TYPE tree_leaves gauge\n"
+		"tree_leaves 0\n"
+		"# HELP tree_height Levels of the tree.\n"
+		"# TYPE tree_height gauge\n"
+		"tree_height 0\n"
+		"# HELP tree_height_ratio Height over the least possible height, 1 is perfectly balanced.\n"
+		"# TYPE tree_height_ratio gauge\n"
+		"tree_height_ratio 0\n"
+		"# HELP tree_mean_search_path Mean comparisons to find a present key.\n"
+		"# TYPE tree_mean_search_path gauge\n"
+		"tree_mean_search_path 0\n"
+		"# HELP tree_max_search_path Comparisons to find the deepest key.\n"
+		"# TYPE tree_max_search_path gauge\n"
+		"tree_max_search_path 0\n"
+		"# HELP tree_node_depth Depth of each node, root at 0.\n"
+		"# TYPE tree_node_depth histogram\n"
+		"tree_node_depth_bucket{le=\"+Inf\"} 0\n"
+		"tree_node_depth_sum 0\n"
+		"tree_node_depth_count 0\n");
+
+	assert(escapeLabelValue("plain") == "plain");
+	assert(escapeLabelValue("\\\"\n") == "\\\\\\\"\\n");
+}
+
+int main()
+{
+	testShape();
+	testJson();
+	testPrometheus();
+	return 0;
+}
@@ -4,7 +4,9 @@
 * Author: James Eli
 * Date: 10/26/2018
 *
-* Basic tree data structure using smart pointers.
+* Basic tree data structure using smart pointers. stats() measures the
+* shape (height, depth histogram, search path lengths) in one pass, see
+* tree_stats.h.
 *
 * Notes:
 *  (1) Compiled/tested with MS Visual Studio 2017 Community (v141), and
@@ -13,6 +15,15 @@
 *************************************************************************
 * Change Log:
 *  10/26/2018: Initial release. JME
+*  10/18/2026: Made add, remove, clear, clone, find, height and balance
+*              checks iterative; nodes tear down their subtrees without
+*              recursion. Deep (degenerate) trees no longer overflow the
+*              stack.
+*  10/18/2026: Added search_many, batched lookups with group prefetching.
+*  10/18/2026: Visual Leak Detector include limited to MSVC builds.
+*  10/18/2026: Added single pass shape statistics, stats().
+*  10/18/2026: add continues from the last added node when the key
+*              belongs there, ascending input no longer descends.
 *************************************************************************/
 #ifndef _MY_TREE_H_
 #define _MY_TREE_H_
@@ -20,13 +31,19 @@
 #include <iostream>  // cout.
 #include <memory>    // shared pointers.
 #include <algorithm> // max.
+#include <cstdlib>   // abs.
+#include <utility>   // pair.
 
+#include "prefetch.h" // search_many node prefetch.
 #include "queue.h"   // bfs traversal.
 #include "stack.h"   // iterative in-order search.
+#include "tree_stats.h" // shape statistics.
 #include "vector.h"  // vector for building balanced tree.
 
-// Visual Leak Detector.
+// Visual Leak Detector (MSVC builds, unless NO_VLD is defined).
+#if defined(_MSC_VER) && !defined(NO_VLD)
 #include "C:\Program Files (x86)\Visual Leak Detector\include\vld.h"
+#endif
 
 template <class T>
 class Tree
@@ -42,22 +59,29 @@ private:
 		bool isLeaf() const { return !left && !right; }
 
 	public:
-		explicit Node(T data) : left(nullptr), right(nullptr), data(data) { }
-		~Node() = default;
+		explicit Node(T data) : data(data), left(nullptr), right(nullptr) { }
+		// Tear down children iteratively, deep subtrees would otherwise
+		// recurse through the shared_ptr destructor chain.
+		~Node()
+		{
+			Tree<T>::destroy(left);
+			Tree<T>::destroy(right);
+		}
 
-		template <typename T>
+		template <typename U>
 		friend class Tree;
 	};
 
 public:
-	Tree() : root(nullptr) { }
+	Tree() : root(nullptr), last(nullptr), bound(nullptr) { }
+	Tree(const Tree<T>& rhs) : root(clone(rhs.root)), last(nullptr), bound(nullptr) { }
 	~Tree() { clear(); }
 
 	const Tree<T>& operator= (const Tree<T> &rhs)
 	{
 		if (this != &rhs)
 		{
-			clear(root);
+			clear();
 			root = clone(rhs.root);
 		}
 		return *this;
@@ -67,10 +91,10 @@ public:
 	//
 	// Basic tree functionality.
 
-	void clear() { clear(root); }
+	void clear() { resetFinger(); clear(root); }
 	bool empty() const { return (root == nullptr); }
 	void add(T data) { add(root, data); }
-	bool remove(T data) { return remove(root, data); }
+	bool remove(T data) { resetFinger(); return remove(root, data); }
 
 	//
 	//
@@ -81,6 +105,9 @@ public:
 	bool search(T data) const { return search(root, data); }
 	// Iterative in-order search.
 	bool iSearch(T data) const { return iInorderSearch(root, data); }
+	// Search n keys at once with interleaved, prefetched descents. Sets
+	// found[i] if keys[i] is present, returns the number found.
+	std::size_t search_many(const T* keys, std::size_t n, bool* found) const { return searchMany(root.get(), keys, n, found); }
 
 	//
 	//
@@ -104,104 +131,166 @@ public:
 
 	// Get height of node. Used by isBalanced function.
 	int getHeight() { return getHeight(root); }
-	// Recursive check of tree balance. Returns true if tree is balanced.
+	// Single pass check of tree balance. Returns true if tree is balanced.
 	bool isBalanced() { return isBalanced(root); }
+	// Shape statistics in a single O(n) pass.
+	treeStats stats() const
+	{
+		return measureShape(root.get(), [](const Node* n) { return n->left.get(); }, [](const Node* n) { return n->right.get(); });
+	}
 	// Attempt to balance tree.
-	void balance() { balanceTree(root); }
+	void balance() { resetFinger(); balanceTree(root); }
 
 private:
 	// Tree root node.
 	std::shared_ptr<Node> root;
-
-	// Internal method to clone subtree.
-	std::shared_ptr<Node> clone(std::shared_ptr<Node> t)
+	// Insert finger: the last added node, and the nearest node above it
+	// whose left subtree holds it (nullptr if none). Keys from last up to
+	// bound belong at last's right, which is still empty.
+	Node* last;
+	Node* bound;
+	// Descents interleaved by search_many.
+	static const std::size_t SEARCH_GROUP = 16;
+
+	// Internal method to clone subtree, iteratively.
+	static std::shared_ptr<Node> clone(std::shared_ptr<Node> t)
 	{
 		if (t == nullptr)
 			return nullptr;
-		return std::make_shared<Node>(Node(t->element, clone(t->left), clone(t->right)));
-	}
 
-	// Delete all nodes of tree.
-	void clear(std::shared_ptr<Node> &node)
-	{
-		if (node->left)
-			clear(node->left);
+		std::shared_ptr<Node> copy = std::make_shared<Node>(t->data);
+		Stack<std::shared_ptr<Node>> src, dst;
 
-		if (node->right)
-			clear(node->right);
+		src.push(t);
+		dst.push(copy);
+		while (!src.empty())
+		{
+			std::shared_ptr<Node> from = src.pop(), to = dst.pop();
 
-		node.reset(); //node.~shared_ptr();
-	}
+			if (from->left)
+			{
+				to->left = std::make_shared<Node>(from->left->data);
+				src.push(from->left);
+				dst.push(to->left);
+			}
+			if (from->right)
+			{
+				to->right = std::make_shared<Node>(from->right->data);
+				src.push(from->right);
+				dst.push(to->right);
+			}
+		}
 
-	// Add new node to tree.
-	void add(std::shared_ptr<Node> &node, T &data)
-	{
-		if (!node)
-			node = std::make_shared<Node>(data);
-		else
-			data < node->data ? add(node->left, data) : add(node->right, data);
+		return copy;
 	}
 
-	// Return minimum value of either child nodes.
-	T min(std::shared_ptr<Node> node) const
+	// Delete all nodes of tree.
+	void clear(std::shared_ptr<Node> &node) { destroy(node); }
+
+	// Release subtree in O(n) without recursion. Left children are rotated
+	// up until the current node has none, then it is released and its right
+	// child visited.
+	static void destroy(std::shared_ptr<Node> &node)
 	{
-		if (node->isLeaf())
-			return node->data;
+		std::shared_ptr<Node> p = std::move(node);
 
-		return node->left ? min(node->left) : min(node->right);
+		while (p)
+		{
+			if (p->left)
+			{
+				std::shared_ptr<Node> l = std::move(p->left);
+				p->left = std::move(l->right);
+				l->right = std::move(p);
+				p = std::move(l);
+			}
+			else
+				p = std::move(p->right);
+		}
 	}
 
-	// Remove first instance of data from tree.
-	bool remove(std::shared_ptr<Node>& node, T data)
+	void resetFinger() { last = bound = nullptr; }
+
+	// Add new node to tree, at the finger without a descent when data
+	// belongs there.
+	void add(std::shared_ptr<Node> &node, T &data)
 	{
-		if (!node)
-			return false;
+		std::shared_ptr<Node>* link = &node;
+
+		if (last && !(data < last->data) && (!bound || data < bound->data))
+			link = &last->right;
 		else
 		{
-			if (node->data == data)
+			bound = nullptr;
+			while (*link)
 			{
-				if (node->isLeaf())
-					node.reset();
-				else
+				if (data < (*link)->data)
 				{
-					// Does node have 2 children?
-					if (node->left && node->right)
-					{
-						T dataReplace = min(node->right);
+					bound = link->get();
+					link = &(*link)->left;
+				}
+				else
+					link = &(*link)->right;
+			}
+		}
 
-						remove(dataReplace);
-						node->data = dataReplace;
-					}
-					else
-					{
-						// 1 child.
-						std::shared_ptr<Node> tempPtr;
+		*link = std::make_shared<Node>(data);
+		last = link->get();
+	}
 
-						node->left ? tempPtr = node->left : tempPtr = node->right;
-						node.reset();   // Decrement use count.
-						node = tempPtr; // Replace with only child.
-					}
-				}
+	// Remove first instance of data found descending from node.
+	bool remove(std::shared_ptr<Node>& node, T data)
+	{
+		std::shared_ptr<Node>* link = &node;
 
-				return true;
-			}
+		while (*link && !((*link)->data == data))
+			link = data < (*link)->data ? &(*link)->left : &(*link)->right;
 
-			return remove(node->left, data) || remove(node->right, data);
+		if (!*link)
+			return false;
+
+		std::shared_ptr<Node> target = *link;
+		if (target->left && target->right)
+		{
+			// Node has 2 children, take over successor's data and unlink
+			// the successor instead (it has no left child).
+			link = &target->right;
+			while ((*link)->left)
+				link = &(*link)->left;
+			target->data = (*link)->data;
+			target = *link;
 		}
+
+		// 0 or 1 child, promote it.
+		std::shared_ptr<Node> child = target->left ? target->left : target->right;
+		target->left.reset();
+		target->right.reset();
+		*link = child;
+
+		return true;
 	}
 
-	// Find first occurance of data in tree.
+	// Find first occurance of data in tree, pre-order.
 	bool find(std::shared_ptr<Node> node, T &data) const
 	{
-		if (!node)
-			return false;
-		else
+		Stack<std::shared_ptr<Node>> stack;
+
+		if (node)
+			stack.push(node);
+
+		while (!stack.empty())
 		{
+			node = stack.pop();
+
 			if (node->data == data)
 				return true;
 
-			return find(node->left, data) || find(node->right, data);
+			if (node->right)
+				stack.push(node->right);
+			if (node->left)
+				stack.push(node->left);
 		}
+
+		return false;
 	}
 
 	// Non-recursive search.
@@ -217,6 +306,57 @@ private:
 		return false;
 	}
 
+	// Group prefetched search. Descents of SEARCH_GROUP keys advance a
+	// level at a time, each prefetching its next node, so the cache misses
+	// of the group overlap. Raw pointers, no reference count traffic.
+	std::size_t searchMany(const Node* top, const T* keys, std::size_t n, bool* found) const
+	{
+		const Node* cursor[SEARCH_GROUP];
+		std::size_t hits = 0;
+
+		for (std::size_t base = 0; base < n; base += SEARCH_GROUP)
+		{
+			std::size_t group = n - base < SEARCH_GROUP ? n - base : SEARCH_GROUP;
+			std::size_t active = top ? group : 0;
+
+			for (std::size_t i = 0; i < group; i++)
+			{
+				cursor[i] = top;
+				found[base + i] = false;
+			}
+
+			while (active)
+			{
+				active = 0;
+				for (std::size_t i = 0; i < group; i++)
+				{
+					const Node* p = cursor[i];
+					if (p == nullptr)
+						continue;
+
+					const T& key = keys[base + i];
+					if (key == p->data)
+					{
+						found[base + i] = true;
+						hits++;
+						p = nullptr;
+					}
+					else
+						p = key < p->data ? p->left.get() : p->right.get();
+
+					if (p)
+					{
+						prefetch(p);
+						active++;
+					}
+					cursor[i] = p;
+				}
+			}
+		}
+
+		return hits;
+	}
+
 	// Iterative in-order search using a stack.
 	bool iInorderSearch(std::shared_ptr<Node> p, T target) const
 	{
@@ -394,19 +534,62 @@ private:
 	// Get height of node. Used by isBalanced function.
 	static int getHeight(std::shared_ptr<Node> node)
 	{
-		return node == nullptr ? 0 : std::max(getHeight(node->left), getHeight(node->right)) + 1;
+		Stack<std::pair<std::shared_ptr<Node>, int>> stack;
+		int height = 0;
+
+		if (node)
+			stack.push(std::make_pair(node, 1));
+
+		while (!stack.empty())
+		{
+			std::pair<std::shared_ptr<Node>, int> top = stack.pop();
+
+			height = std::max(height, top.second);
+			if (top.first->left)
+				stack.push(std::make_pair(top.first->left, top.second + 1));
+			if (top.first->right)
+				stack.push(std::make_pair(top.first->right, top.second + 1));
+		}
+
+		return height;
 	}
 
-	// Check if tree is balanced.
+	// Check if tree is balanced, single post-order pass. Subtree heights
+	// are kept on a second stack as children complete.
 	static bool isBalanced(std::shared_ptr<Node> node)
 	{
-		if (node == nullptr)
-			return true;
+		Stack<std::shared_ptr<Node>> stack;
+		Stack<int> heights;
+		std::shared_ptr<Node> last;
 
-		int left = getHeight(node->left);
-		int right = getHeight(node->right);
+		while (node || !stack.empty())
+		{
+			if (node)
+			{
+				stack.push(node);
+				node = node->left;
+				continue;
+			}
 
-		return (abs(left - right) <= 1 && isBalanced(node->left) && isBalanced(node->right));
+			std::shared_ptr<Node> top = stack.top();
+			if (top->right && top->right != last)
+			{
+				node = top->right;
+				continue;
+			}
+
+			stack.pop();
+			int right = top->right ? heights.pop() : 0;
+			int left = top->left ? heights.pop() : 0;
+
+			if (abs(left - right) > 1)
+				return false;
+
+			heights.push(std::max(left, right) + 1);
+			last = top;
+		}
+
+		return true;
 	}
 	/*
 	// Returns true if tree is balanced. Second parameter stores tree height.
@@ -471,17 +654,24 @@ private:
 		}
 	}
 
-	// Balance tree helper method, constructs sorted array of tree data via inOrder traversal.
+	// Balance tree helper method, constructs sorted array of tree data via
+	// iterative inOrder traversal.
 	void makeArray(std::shared_ptr<Node> node, Vector<T>& data)
 	{
-		// Base case.
-		if (!node)
-			return;
-
-		// Store tree nodes inorder.
-		makeArray(node->left, data);
-		data.push_back(node->data);
-		makeArray(node->right, data);
+		Stack<std::shared_ptr<Node>> stack;
+
+		while (node || !stack.empty())
+		{
+			while (node)
+			{
+				stack.push(node);
+				node = node->left;
+			}
+
+			node = stack.pop();
+			data.push_back(node->data);
+			node = node->right;
+		}
 	}
 
 	// Attempt to reconstruct tree as balanced. 
@@ -493,7 +683,7 @@ private:
 
 		// Reconstruct a balanced tree.
 		clear(root);
-		buildTree(data, 0, data.size() - 1);
+		buildTree(data, 0, static_cast<int>(data.size()) - 1);
 	}
 
 };
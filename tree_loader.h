@@ -0,0 +1,211 @@
+/*************************************************************************
+* Title: Tree Loader
+* File: tree_loader.h
+* Date: 10/18/2026
+*
+* Streaming bulk loading of tree<T> from files:
+*
+*   loader::text(tree, is)   // delimited text keys. Numbers are separated
+*                            // by any whitespace, strings by newlines.
+*   loader::binary(tree, is) // packed raw T records (native byte order).
+*
+* Both return the number of keys loaded and throw runtime_error on a
+* malformed key, a truncated record or a stream error.
+*
+* Notes:
+*  (1) Input is read in large chunks and numbers parsed in place with
+*      std::from_chars, no per key stream extraction. Requires C++17.
+*  (2) Keys are collected into batches handed to tree<T>::insert_batch,
+*      which leaves sorted batches as they are, merges batches made of a
+*      few sorted runs, and builds keys landing on an empty subtree as a
+*      balanced subtree in O(n). A batch still sorted when it fills keeps
+*      growing until the input turns down, so a sorted file loaded into
+*      an empty tree becomes one balanced tree with no per key descent.
+*  (3) Text files may use CRLF line endings. Blank lines are skipped.
+*************************************************************************
+* Change Log:
+*  10/18/2026: Initial release.
+*  10/18/2026: Accept trees of any instrumentation policy.
+*  10/18/2026: Skip blank CRLF lines instead of loading empty strings.
+*************************************************************************/
+#ifndef _TREE_LOADER_H_
+#define _TREE_LOADER_H_
+
+#include <charconv>    // from_chars.
+#include <cstring>     // memmove.
+#include <istream>     // input streams.
+#include <stdexcept>   // runtime error.
+#include <string>      // string keys, error messages.
+#include <type_traits> // enable_if, is_arithmetic.
+#include <vector>      // read buffer, key batches.
+#include "tree_with_parent.h"
+
+namespace loader
+{
+	// Keys per insert_batch call.
+	const std::size_t BATCH = 1 << 20;
+	// Bytes per stream read.
+	const std::size_t BUFFER = 1 << 20;
+
+	// Parse a whole token as a number.
+	template <class T>
+	typename std::enable_if<std::is_arithmetic<T>::value, bool>::type
+	parseKey(const char* first, const char* last, T& key)
+	{
+		std::from_chars_result r = std::from_chars(first, last, key);
+		return r.ec == std::errc() && r.ptr == last;
+	}
+
+	// A line is a string key.
+	inline bool parseKey(const char* first, const char* last, std::string& key)
+	{
+		key.assign(first, last);
+		return true;
+	}
+
+	// Collects keys into batches for tree<T>::insert_batch. A batch that
+	// is still one sorted run keeps growing past the batch size, so sorted
+	// input reaches the tree as a single run.
+	template <class T, class Policy>
+	class batcher
+	{
+	public:
+		batcher(tree<T, Policy>& t, std::size_t batch) : t(t), batch(batch ? batch : 1), sorted(true), loaded(0)
+		{
+			keys.reserve(this->batch);
+		}
+
+		void push(const T& key)
+		{
+			if (keys.size() && key < keys.back())
+			{
+				if (keys.size() >= batch)
+					flush();
+				else
+					sorted = false;
+			}
+
+			keys.push_back(key);
+			if (!sorted && keys.size() >= batch)
+				flush();
+		}
+
+		// Insert pending keys, returns total keys inserted.
+		std::size_t flush()
+		{
+			t.insert_batch(keys.begin(), keys.end());
+			loaded += keys.size();
+			keys.clear();
+			sorted = true;
+			return loaded;
+		}
+
+	private:
+		tree<T, Policy>& t;
+		std::size_t batch;
+		std::vector<T> keys;
+		bool sorted;
+		std::size_t loaded;
+	};
+
+	template <class T>
+	bool isDelimiter(char c)
+	{
+		return std::is_arithmetic<T>::value
+			? c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\f' || c == '\v'
+			: c == '\n';
+	}
+
+	// Load delimited text keys into t.
+	template <class T, class Policy>
+	std::size_t text(tree<T, Policy>& t, std::istream& is, std::size_t batch = BATCH)
+	{
+		std::vector<char> buffer(BUFFER);
+		batcher<T, Policy> keys(t, batch);
+		std::size_t have = 0, line = 1;
+		bool eof = false;
+
+		while (!eof)
+		{
+			is.read(buffer.data() + have, buffer.size() - have);
+			std::size_t got = static_cast<std::size_t>(is.gcount());
+			have += got;
+			eof = !is;
+
+			const char* p = buffer.data();
+			const char* end = p + have;
+			for (;;)
+			{
+				while (p != end && isDelimiter<T>(*p))
+					line += *p++ == '\n';
+				if (p == end)
+					break;
+
+				// Token cut by the end of the buffer, finish it next read.
+				const char* q = p;
+				while (q != end && !isDelimiter<T>(*q))
+					++q;
+				if (q == end && !eof)
+					break;
+
+				// A blank CRLF line is skipped as a blank LF line is.
+				const char* last = q;
+				if (last[-1] == '\r' && --last == p)
+				{
+					p = q;
+					continue;
+				}
+
+				T key;
+				if (!parseKey(p, last, key))
+					throw std::runtime_error("loader::text: bad key at line " + std::to_string(line));
+
+				keys.push(key);
+				p = q;
+			}
+
+			// Keep the partial token, growing the buffer for one that fills it.
+			have = end - p;
+			std::memmove(buffer.data(), p, have);
+			if (have == buffer.size())
+				buffer.resize(buffer.size() * 2);
+		}
+
+		if (is.bad())
+			throw std::runtime_error("loader::text: read failed");
+
+		return keys.flush();
+	}
+
+	// Load packed T records into t.
+	template <class T, class Policy>
+	std::size_t binary(tree<T, Policy>& t, std::istream& is, std::size_t batch = BATCH)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "loader::binary requires trivially copyable T");
+
+		std::vector<T> records(BUFFER / sizeof(T) + 1);
+		batcher<T, Policy> keys(t, batch);
+
+		for (;;)
+		{
+			is.read(reinterpret_cast<char*>(records.data()), records.size() * sizeof(T));
+			std::size_t bytes = static_cast<std::size_t>(is.gcount());
+
+			if (bytes % sizeof(T))
+				throw std::runtime_error("loader::binary: truncated record");
+
+			for (std::size_t i = 0; i < bytes / sizeof(T); i++)
+				keys.push(records[i]);
+
+			if (bytes < records.size() * sizeof(T))
+				break;
+		}
+
+		if (is.bad())
+			throw std::runtime_error("loader::binary: read failed");
+
+		return keys.flush();
+	}
+}
+
+#endif
@@ -0,0 +1,195 @@
+/*************************************************************************
+* Title: Tree Shape Statistics
+* File: tree_stats.h
+* Date: 10/18/2026
+*
+* Shape of a binary tree measured in one pass, behind Tree<T>::stats()
+* and tree<T>::stats():
+*
+*   treeStats s = t.stats();
+*   s.nodes, s.leaves, s.height  // height counts levels, root alone is 1.
+*   s.depths[d]                  // nodes at depth d, root at depth 0.
+*   s.meanPath(), s.maxPath()    // comparisons of a successful search,
+*                                // averaged over all nodes, and worst.
+*   s.heightRatio()              // height over the least possible height,
+*                                // ceil(log2(n + 1)); 1 is perfect.
+*
+*   writeJson(os, s)             // one JSON object.
+*   writePrometheus(os, s, name, labels)
+*                                // Prometheus text exposition format,
+*                                // labels as name, value pairs.
+*
+*   measureShape(root, left, right)
+*                                // the pass itself, for any node type.
+*
+* Notes:
+*  (1) O(n) time and O(height) extra memory, iterative, so degenerate
+*      trees do not overflow the stack.
+*  (2) A growing heightRatio is the early sign of degeneration: search
+*      cost follows meanPath, which tracks height long before latency
+*      does. Alert on heightRatio, say above 2 or 3.
+*  (3) Prometheus gets the depth histogram with power of two buckets
+*      (le 1, 2, 4, ...), JSON gets every depth.
+*  (4) Label values are escaped (backslash, double quote, newline), label
+*      and metric names are written as given.
+*************************************************************************
+* Change Log:
+*  10/18/2026: Initial release.
+*  10/18/2026: Prometheus labels passed as name, value pairs, values
+*              escaped.
+*************************************************************************/
+#ifndef _TREE_STATS_H_
+#define _TREE_STATS_H_
+
+#include <cmath>    // log2, ceil.
+#include <cstddef>  // size_t.
+#include <ostream>  // export.
+#include <string>   // metric names.
+#include <utility>  // pair.
+#include <vector>   // depth histogram, walk stack.
+
+struct treeStats
+{
+	std::size_t nodes = 0;            // Node count.
+	std::size_t leaves = 0;           // Nodes without children.
+	std::size_t height = 0;           // Levels, 0 if empty.
+	std::size_t totalDepth = 0;       // Sum of node depths.
+	std::vector<std::size_t> depths;  // Nodes per depth, size height.
+
+	// Mean comparisons to find a present key, depth + 1 averaged.
+	double meanPath() const { return nodes ? static_cast<double>(totalDepth + nodes) / nodes : 0.0; }
+
+	// Comparisons to find the deepest key.
+	std::size_t maxPath() const { return height; }
+
+	// Least height of a tree of this size.
+	std::size_t optimalHeight() const
+	{
+		return nodes ? static_cast<std::size_t>(std::ceil(std::log2(static_cast<double>(nodes) + 1.0))) : 0;
+	}
+
+	double heightRatio() const { return nodes ? static_cast<double>(height) / optimalHeight() : 0.0; }
+};
+
+// Walks the tree below root, left(n) and right(n) returning child
+// pointers, null for none.
+template <class Node, class Left, class Right>
+treeStats measureShape(const Node* root, Left left, Right right)
+{
+	treeStats s;
+	std::vector<std::pair<const Node*, std::size_t>> stack;
+
+	if (root)
+		stack.push_back(std::make_pair(root, std::size_t(0)));
+
+	while (!stack.empty())
+	{
+		const Node* node = stack.back().first;
+		std::size_t depth = stack.back().second;
+		stack.pop_back();
+
+		s.nodes++;
+		s.totalDepth += depth;
+		if (depth >= s.depths.size())
+			s.depths.resize(depth + 1, 0);
+		s.depths[depth]++;
+
+		const Node* l = left(node);
+		const Node* r = right(node);
+		if (!l && !r)
+			s.leaves++;
+		if (r)
+			stack.push_back(std::make_pair(r, depth + 1));
+		if (l)
+			stack.push_back(std::make_pair(l, depth + 1));
+	}
+
+	s.height = s.depths.size();
+	return s;
+}
+
+inline void writeJson(std::ostream& os, const treeStats& s)
+{
+	os << "{ \"nodes\": " << s.nodes
+		<< ", \"leaves\": " << s.leaves
+		<< ", \"height\": " << s.height
+		<< ", \"optimal_height\": " << s.optimalHeight()
+		<< ", \"height_ratio\": " << s.heightRatio()
+		<< ", \"mean_path\": " << s.meanPath()
+		<< ", \"max_path\": " << s.maxPath()
+		<< ", \"depths\": [";
+	for (std::size_t d = 0; d < s.depths.size(); d++)
+		os << (d ? ", " : "") << s.depths[d];
+	os << "] }";
+}
+
+// Prometheus label name, value pairs.
+typedef std::vector<std::pair<std::string, std::string>> metricLabels;
+
+// Label value escaped for the text exposition format.
+inline std::string escapeLabelValue(const std::string& value)
+{
+	std::string out;
+
+	out.reserve(value.size());
+	for (char c : value)
+	{
+		if (c == '\\')
+			out += "\\\\";
+		else if (c == '"')
+			out += "\\\"";
+		else if (c == '\n')
+			out += "\\n";
+		else
+			out += c;
+	}
+	return out;
+}
+
+// Metrics named name_nodes, name_height, ..., each labelled with labels,
+// e.g. { { "tree", "orders" } }.
+inline void writePrometheus(std::ostream& os, const treeStats& s, const std::string& name = "tree", const metricLabels& labels = metricLabels())
+{
+	std::string inner;
+	for (const std::pair<std::string, std::string>& label : labels)
+		inner += (inner.empty() ? "" : ",") + label.first + "=\"" + escapeLabelValue(label.second) + "\"";
+
+	const std::string l = inner.empty() ? "" : "{" + inner + "}";
+	const std::string sep = inner.empty() ? "" : inner + ",";
+
+	struct gauge { const char* suffix; const char* help; double value; };
+	const gauge gauges[] =
+	{
+		{ "nodes", "Number of nodes.", static_cast<double>(s.nodes) },
+		{ "leaves", "Number of leaf nodes.", static_cast<double>(s.leaves) },
+		{ "height", "Levels of the tree.", static_cast<double>(s.height) },
+		{ "height_ratio", "Height over the least possible height, 1 is perfectly balanced.", s.heightRatio() },
+		{ "mean_search_path", "Mean comparisons to find a present key.", s.meanPath() },
+		{ "max_search_path", "Comparisons to find the deepest key.", static_cast<double>(s.maxPath()) },
+	};
+
+	for (const gauge& g : gauges)
+	{
+		os << "# HELP " << name << "_" << g.suffix << " " << g.help << "\n"
+			<< "# TYPE " << name << "_" << g.suffix << " gauge\n"
+			<< name << "_" << g.suffix << l << " " << g.value << "\n";
+	}
+
+	// Node depths as a cumulative histogram, root at depth 0.
+	const std::string h = name + "_node_depth";
+	std::size_t below = 0, d = 0;
+
+	os << "# HELP " << h << " Depth of each node, root at 0.\n"
+		<< "# TYPE " << h << " histogram\n";
+	for (std::size_t le = 1; d < s.depths.size(); le *= 2)
+	{
+		for (; d < s.depths.size() && d <= le; d++)
+			below += s.depths[d];
+		os << h << "_bucket{" << sep << "le=\"" << le << "\"} " << below << "\n";
+	}
+	os << h << "_bucket{" << sep << "le=\"+Inf\"} " << s.nodes << "\n"
+		<< h << "_sum" << l << " " << s.totalDepth << "\n"
+		<< h << "_count" << l << " " << s.nodes << "\n";
+}
+
+#endif
@@ -9,55 +9,175 @@
 *
 *   clear()      // deletes tree.
 *   empty()      // returns true if tree is empty.
-*   size()       // returns tree size (number of nodes).
-*   add(T)       // recursive insert new node. does NOT check if T
+*   size()       // returns tree size (number of nodes), O(1).
+*   add(T)       // insert new node, starting from the last insert
+*                // position when possible. does NOT check if T
 *                // already exists.
-*   find(T)      // recursively find first occurance of data in tree.
+*   insert(it, T)// insert new node using iterator hint.
+*   insert_unique(T)
+*                // insert unless an equal key is present, one descent.
+*   emplace_unique(key, make)
+*                // insert_unique by a key comparable with T, make()
+*                // building the element only when the key is absent.
+*   erase(it)    // remove the element at it, no descent.
+*   insert_batch(first, last)
+*                // sort a batch and merge it in one combined traversal.
+*   search_many(keys, n, found)
+*                // search a group of keys with interleaved descents.
+*   find(T)      // find first occurance of data in tree (pre-order).
 *                // returns true if T is found.
+*   lower_bound(key)
+*                // iterator to the first element not less than key.
 *   inOrder()    // dfs inorder recursive traversal.
 *   bfs()        // bfs non-recursive traversal (top down, left to right).
+*   enableFilter(fpRate)
+*                // keep a Bloom filter so most misses skip the descent.
+*   enableCache(slots)
+*                // cache hot keys found by search, skipping descents.
+*   enableAutoBalance(knobs)
+*                // balance automatically once inserts land too deep.
+*   rebalance_start(perOp), rebalance_step(budget)
+*                // balance in bounded slices, tree usable meanwhile.
 *   getHeight()  // returns height of tree.
 *   isBalanced() // returns true if tree is balanced.
+*   stats()      // node count, height, depth histogram and search path
+*                // lengths in one pass (tree_stats.h).
 *   balance()    // attempts to balance tree.
+*   save(os)     // write sorted keys to a binary stream (trivially
+*                // copyable T only).
+*   load(is)     // replace tree with keys read by save, O(n).
 *
 * Notes:
 *  (1) Compiled/tested with MS Visual Studio 2017 Community (v141), and
 *      Windows SDK version 10.0.17134.0 (32 & 64-bit), and with Eclipse
 *      Oxygen.3a Release (4.7.3a), using CDT 9.4.3 MinGw32 gcc-g++ (6.3.0-1).
+*  (2) With the hot key cache enabled search writes to the cache, and
+*      during an incremental rebalance it does rebalancing work, so
+*      concurrent searches need the same exclusion as modifications.
+*  (3) Policy (instrument.h) is told about every operation, comparison,
+*      node visit, allocation and rebuild. The default noStats compiles to
+*      nothing; countingStats counts per operation, read with
+*      policy().snapshot(); latencyStats (latency.h) keeps per operation
+*      latency histograms.
+*  (4) Iterators are raw node pointers and end() is a header node above
+*      the root, which links to the leftmost and rightmost nodes: begin,
+*      end, rbegin and rend are O(1), --end() is the maximum, and ++ never
+*      touches a reference count. Parent links are raw pointers too. The
+*      header holds links only, so T needs no default constructor.
 *************************************************************************
 * Change Log:
 *  10/26/2018: Initial release. JME
 *  04/16/2020: Added parent link and iterators. JME
 *  04/19/2020: Separated node and iterators classes from tree class. JME
+*  10/18/2026: Added batched insertion.
+*  10/18/2026: Added hinted insertion and insert position finger.
+*  10/18/2026: Structural operations made iterative, parent link made
+*              non-owning (weak), so deep trees no longer overflow the
+*              stack on insert, remove, clear or destruction.
+*  10/18/2026: Added binary save and load.
+*  10/18/2026: insert_batch merges presorted runs instead of sorting.
+*  10/18/2026: Added search_many.
+*  10/18/2026: Added optional Bloom filter for negative lookups.
+*  10/18/2026: Added optional hot key cache for search.
+*  10/18/2026: Iterator positioning (begin, rbegin) reported as OP_BEGIN.
+*  10/18/2026: Added single pass shape statistics, stats().
+*  10/18/2026: Added automatic, depth triggered rebalancing.
+*  10/18/2026: Added incremental rebalancing in bounded slices.
+*  10/18/2026: Added instrumentation policy parameter, tree<T, Policy>.
+*  10/18/2026: Own include guard, so tree.h can be included alongside.
+*  10/18/2026: Added insert_unique and lower_bound.
+*  10/18/2026: Added emplace_unique, erase, lower_bound by any key.
+*  10/18/2026: Header node caching the leftmost and rightmost nodes,
+*              O(1) begin and end, decrement from end(), raw pointer
+*              iterators and parent links. Fixed const_iterator and
+*              reverse iterator decrement and post-increment.
+*  10/18/2026: Automatic rebalancing depthFactor defaults to 3, past the
+*              depth random insertion orders reach.
+*  10/18/2026: Header node without data, links split into NodeBase, so
+*              T needs no default constructor; load constructs its block
+*              node by node. Standard iterator typedefs.
+*  10/18/2026: Inserted elements moved into their nodes, not copied, so
+*              move-only T works; incremental rebalancing needs copyable T.
+*  10/18/2026: load checks the key count against the stream length before
+*              allocating.
+*  10/18/2026: end() and rend() reported as OP_BEGIN too.
 *************************************************************************/
-#ifndef _MY_TREE_H_
-#define _MY_TREE_H_
+#ifndef _MY_TREE_WITH_PARENT_H_
+#define _MY_TREE_WITH_PARENT_H_
 
 #include <iostream>  // cout.
 #include <memory>    // shared pointers.
 #include <algorithm> // max.
+#include <cmath>     // log2, pow, floor.
+#include <cstddef>   // ptrdiff_t.
+#include <cstdlib>   // abs.
+#include <cstdint>   // fixed width file header fields.
+#include <cstring>   // memcmp.
+#include <iterator>  // iterator tags.
+#include <new>       // placement new of load's node block.
+#include <stdexcept> // runtime_error.
 #include <string>    // printTree function.
+#include <type_traits> // is_trivially_copyable.
+#include <utility>   // pair.
+#include "bloom.h"   // negative lookup filter.
+#include "instrument.h" // operation counters policy.
+#include "prefetch.h" // search_many node prefetch.
 #include "queue.h"   // bfs traversal.
 #include "stack.h"   // iterative in-order search.
+#include "tree_stats.h" // shape statistics.
 #include "vector.h"  // vector for building balanced tree.
 //#include <vector>
 
-template <class T>
-class tree
+template <class T, class Policy = noStats>
+class tree : private Policy
 {
 protected:
 	struct Node;
 
+	// Links of a node, apart so the header holds no T.
+	struct NodeBase
+	{
+		std::shared_ptr<Node> left = nullptr;
+		std::shared_ptr<Node> right = nullptr;
+		NodeBase* parent = nullptr; // Non-owning, the tree's header above the root.
+	};
+
+	// Builds balanced versions in the background (shared_tree.h).
+	template <class U, class P> friend class sharedTree;
+
 public:
-	tree() : root(nullptr) { }
-	~tree() { clear(root); }
+	tree() : root(nullptr), count(0) { }
+	tree(const tree& rhs) : Policy(), root(clone(rhs.root)), count(rhs.count),
+		filter(rhs.filter), filterRate(rhs.filterRate), filterKeys(rhs.filterKeys)
+	{
+		setEnds();
+		if (rhs.cacheSlots)
+			enableCache(rhs.cacheSlots);
+	}
+	~tree()
+	{
+		clear(root);
+		rebalanceCancel(true);
+		// Not owned, must not be released with the header.
+		header.left.reset();
+		header.right.reset();
+	}
 
-	const tree<T>& operator= (const tree<T>& rhs)
+	const tree& operator= (const tree& rhs)
 	{
 		if (this != &rhs)
 		{
-			clear(root);
+			clear();
 			root = clone(rhs.root);
+			setEnds();
+			count = rhs.count;
+			filter = rhs.filter;
+			filterRate = rhs.filterRate;
+			filterKeys = rhs.filterKeys;
+			if (rhs.cacheSlots)
+				enableCache(rhs.cacheSlots);
+			else
+				disableCache();
 		}
 		return *this;
 	}
@@ -66,23 +186,76 @@ public:
 	// Basic tree functionality.
 	//
 
-	void clear() { clear(root); }
+	void clear() { clear(root); setEnds(); count = 0; resetFinger(); clearFilter(); generation++; rebalanceCancel(true); }
 	bool empty() const { return (root == nullptr); }
-	void add(T data) { add(root, nullptr, data); }
-	bool remove(T data) { return remove(root, data); }
-	std::size_t size() { return size(root); }
+	void add(T data) { opScope<Policy> scope(policy(), OP_ADD); insertNear(data); autoBalanceCheck(); rebalanceTick(); }
+	bool remove(T data)
+	{
+		opScope<Policy> scope(policy(), OP_REMOVE);
+		resetFinger();
+		generation++;
+		bool removed = remove(root, data, true);
+		if (removed && autoBalanceOn)
+			balanceOps++;
+		rebalanceTick();
+		return removed;
+	}
+	std::size_t size() const { return count; }
+
+	// Insert a batch of elements. The batch is sorted and merged into the
+	// tree in a single traversal, each run of keys descending once into
+	// the subtree it belongs to. Runs landing on an empty subtree are built
+	// there directly as a balanced subtree. Batches made of a few already
+	// sorted runs are merged rather than fully sorted.
+	template <class InputIt>
+	void insert_batch(InputIt first, InputIt last)
+	{
+		opScope<Policy> scope(policy(), OP_ADD);
+		Vector<T> batch;
+		for (; first != last; ++first)
+			batch.push_back(*first);
+
+		if (batch.size() == 0)
+			return;
+
+		T* keys = &batch[0];
+		sortRuns(keys, batch.size());
+
+		rebalanceCancel(false);
+		resetFinger();
+		insertRuns(keys, batch.size());
+		setEnds();
+		for (std::size_t i = 0; i < batch.size(); i++)
+			filterAdd(keys[i]);
+	}
 
 	//
 	// Searches.
 	//
 
 	// recursive search.
-	bool find(T data) const { return find(root, data); }
-	// Non-recursive search.
-	bool search(T data) const { return search(root, data); }
+	bool find(T data) const { opScope<Policy> scope(policy(), OP_SEARCH); return !filterRejects(data) && find(root, data); }
+	// Non-recursive search, through the hot key cache when enabled.
+	bool search(T data) const
+	{
+		opScope<Policy> scope(policy(), OP_SEARCH);
+		rebalanceTick();
+
+		if (cacheSlots)
+			return cachedSearch(data);
+		return !filterRejects(data) && search(root, data);
+	}
 	// Iterative in-order search.
 	bool iSearch(T data) const { return iInorderSearch(root, data); }
 
+	// Search n keys at once with interleaved, prefetched descents. Sets
+	// found[i] if keys[i] is present, returns the number found.
+	std::size_t search_many(const T* keys, std::size_t n, bool* found) const
+	{
+		opScope<Policy> scope(policy(), OP_SEARCH);
+		return searchMany(root.get(), keys, n, found);
+	}
+
 	//
 	// Traversals.
 	//
@@ -105,11 +278,306 @@ public:
 	//
 
 	// Get height of node. Used by isBalanced function.
-	int getHeight() { return getHeight(root); }
-	// Recursive check of tree balance. Returns true if tree is balanced.
-	bool isBalanced() { return isBalanced(root); }
+	int getHeight() const { return getHeight(root); }
+	// Single pass check of tree balance. Returns true if tree is balanced.
+	bool isBalanced() const { return isBalanced(root); }
+	// Shape statistics in a single O(n) pass.
+	treeStats stats() const
+	{
+		return measureShape(root.get(), [](const Node* n) { return n->left.get(); }, [](const Node* n) { return n->right.get(); });
+	}
 	// Attempt to balance tree.
-	void balance() { balanceTree(root); }
+	void balance() { opScope<Policy> scope(policy(), OP_BALANCE); balanceTree(root); }
+
+	// Instrumentation policy, holding its counters (see instrument.h).
+	const Policy& policy() const { return *this; }
+	Policy& policy() { return *this; }
+
+	//
+	// Negative lookup filter.
+	//
+
+	// Keep a blocked Bloom filter of the keys at false positive rate
+	// fpRate, consulted by search, find and search_many before descending.
+	// Throws logic_error if std::hash<T> is unavailable, invalid_argument
+	// for a rate outside (0, 1).
+	void enableFilter(double fpRate = 0.01)
+	{
+		if (!bloomHashable<T>::value)
+			throw std::logic_error("tree::enableFilter: key type has no std::hash");
+		if (!(fpRate > 0.0 && fpRate < 1.0))
+			throw std::invalid_argument("tree::enableFilter: rate must be in (0, 1)");
+
+		filterRate = fpRate;
+		rebuildFilter();
+	}
+
+	void disableFilter()
+	{
+		filterRate = 0.0;
+		filterKeys = 0;
+		filter = bloomFilter();
+	}
+
+	bool filtered() const { return filterRate > 0.0; }
+	// Filter size in bytes, 0 when disabled.
+	std::size_t filterBytes() const { return filter.bytes(); }
+
+	//
+	// Hot key cache.
+	//
+
+	struct cacheCounters
+	{
+		std::uint64_t hits;   // Searches answered by the cache.
+		std::uint64_t misses; // Searches that descended the tree.
+	};
+
+	// Cache found keys and their nodes in a direct mapped table of slots
+	// entries (rounded up to a power of 2), so repeated searches for hot
+	// keys skip the descent. Entries are invalidated wholesale by remove,
+	// clear, balance and load. Resets the counters. Throws logic_error if
+	// std::hash<T> is unavailable.
+	void enableCache(std::size_t slots = 1024)
+	{
+		if (!bloomHashable<T>::value)
+			throw std::logic_error("tree::enableCache: key type has no std::hash");
+
+		cacheSlots = 1;
+		cacheShift = 64;
+		while (cacheSlots < slots)
+		{
+			cacheSlots <<= 1;
+			cacheShift--;
+		}
+		cache.reset(new cacheEntry[cacheSlots]);
+		cacheCounts = cacheCounters{ 0, 0 };
+	}
+
+	void disableCache()
+	{
+		cache.reset();
+		cacheSlots = 0;
+	}
+
+	cacheCounters cacheStats() const { return cacheCounts; }
+
+	//
+	// Automatic rebalancing.
+	//
+
+	struct autoBalanceKnobs
+	{
+		// Rebalance once an insert lands deeper than depthFactor * log2(size),
+		// >= 1. Random insertion orders reach about 3, so the default leaves
+		// them alone and catches sorted and other skewed input. Lower values
+		// rebuild more often: at 2, a scapegoat tree's usual alpha of 0.7,
+		// 1M sorted adds rebuild a subtree about every other add, at 3 about
+		// every third, either way taking over ten times as long as the adds
+		// alone. 1 allows perfect balance only.
+		double depthFactor = 3.0;
+		// Rate limit: at least spacing * size adds and removes between two
+		// rebuilds, size as of the earlier one, >= 0. 0 keeps the depth
+		// bound at all times.
+		double spacing = 0.0;
+		// No automatic rebuild below this many keys.
+		std::size_t minSize = 64;
+	};
+
+	// Rebalance automatically when an add or hinted insert lands too deep
+	// (see autoBalanceKnobs), scapegoat style: climbing from the new node,
+	// the first subtree lopsided enough to explain the depth is rebuilt
+	// perfectly balanced, in place. Iterators and cached nodes stay valid. The insert
+	// depth comes for free for descents from the root and appends at the
+	// insert finger (sorted and reverse sorted input), other inserts climb
+	// parent links to measure it. Throws invalid_argument for knobs out of
+	// range.
+	void enableAutoBalance() { enableAutoBalance(autoBalanceKnobs()); }
+	void enableAutoBalance(const autoBalanceKnobs& knobs)
+	{
+		if (!(knobs.depthFactor >= 1.0) || !(knobs.spacing >= 0.0))
+			throw std::invalid_argument("tree::enableAutoBalance: depthFactor must be >= 1, spacing >= 0");
+
+		balanceKnobs = knobs;
+		autoBalanceOn = true;
+		balanceOps = 0;
+		balanceSize = count;
+	}
+
+	void disableAutoBalance() { autoBalanceOn = false; }
+	bool autoBalancing() const { return autoBalanceOn; }
+	// Subtrees rebuilt automatically since construction.
+	std::uint64_t autoBalances() const { return autoBalanceCount; }
+
+	//
+	// Incremental rebalancing.
+	//
+
+	// Balance in slices instead of all at once as balance() does. The keys
+	// are copied in order into a balanced shadow tree, changes made in the
+	// meantime are logged and replayed into it, it then replaces the tree
+	// in O(1) and the old nodes are released. Each add, remove and search
+	// does up to perOp units of that work, 0 leaving it all to
+	// rebalance_step. A unit is one key copied, one node linked, one change
+	// replayed (a descent of the shadow tree) or one node released. Moving
+	// the copy to the next key walks at most the height of the tree, as a
+	// search may, and O(1) amortized. The tree stays fully usable
+	// meanwhile. The swap invalidates iterators, as balance() does. clear,
+	// balance, load and insert_batch cancel a rebalance in progress.
+	// Restarting one in progress only changes perOp. T must be copyable.
+	void rebalance_start(std::size_t perOp = 32)
+	{
+		static_assert(KEYS_COPYABLE, "tree::rebalance_start requires copyable T");
+		opScope<Policy> scope(policy(), OP_BALANCE);
+
+		rebalancePerOp = perOp;
+		if (rebalancePhase != REBALANCE_IDLE)
+			return;
+
+		// Room for some growth, the copy grows the buffer at a single step.
+		rebalancePhase = REBALANCE_COLLECT;
+		rebalanceCursor = root ? owner(header.left.get()) : nullptr;
+		rebalanceBefore = 0;
+		rebalanceKeys.reserve(count + count / 2);
+	}
+
+	// Do up to budget units of rebalancing work. Returns true while some
+	// is left.
+	bool rebalance_step(std::size_t budget)
+	{
+		opScope<Policy> scope(policy(), OP_BALANCE);
+		return rebalanceSteps(budget);
+	}
+
+	// True from rebalance_start until the old nodes are all released.
+	bool rebalancing() const { return rebalancePhase != REBALANCE_IDLE || rebalanceRetired.size(); }
+
+	//
+	// Serialization.
+	//
+
+	// Write tree to stream in binary form: a file header followed by the
+	// keys in sorted order. Keys are written as raw bytes in native byte
+	// order, so T must be trivially copyable.
+	void save(std::ostream& os) const
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "tree::save requires trivially copyable T");
+
+		fileHeader h;
+		std::memcpy(h.magic, fileMagic(), sizeof(h.magic));
+		h.version = FILE_VERSION;
+		h.byteOrder = FILE_BYTE_ORDER;
+		h.keySize = sizeof(T);
+		h.count = count;
+		os.write(reinterpret_cast<const char*>(&h), sizeof(h));
+
+		// Iterative in-order walk, keys written a chunk at a time.
+		std::unique_ptr<T[]> chunk(new T[IO_CHUNK]);
+		std::size_t used = 0;
+		Stack<std::shared_ptr<Node>> stack;
+		std::shared_ptr<Node> node = root;
+
+		while (node || !stack.empty())
+		{
+			while (node)
+			{
+				stack.push(node);
+				node = node->left;
+			}
+
+			node = stack.pop();
+			chunk[used++] = node->data;
+			if (used == IO_CHUNK)
+			{
+				os.write(reinterpret_cast<const char*>(chunk.get()), used * sizeof(T));
+				used = 0;
+			}
+			node = node->right;
+		}
+		if (used)
+			os.write(reinterpret_cast<const char*>(chunk.get()), used * sizeof(T));
+
+		if (!os)
+			throw std::runtime_error("tree::save: write failed");
+	}
+
+	// Replace contents with a tree written by save. All nodes are placed
+	// in one contiguous block and linked as a balanced tree in O(n), no
+	// per node allocation. Throws runtime_error on a malformed or truncated
+	// stream or a key count longer than the stream, leaving the tree
+	// unchanged.
+	void load(std::istream& is)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "tree::load requires trivially copyable T");
+
+		fileHeader h;
+		if (!is.read(reinterpret_cast<char*>(&h), sizeof(h)))
+			throw std::runtime_error("tree::load: truncated header");
+		if (std::memcmp(h.magic, fileMagic(), sizeof(h.magic)) != 0)
+			throw std::runtime_error("tree::load: not a tree file");
+		if (h.version != FILE_VERSION)
+			throw std::runtime_error("tree::load: unsupported version");
+		if (h.byteOrder != FILE_BYTE_ORDER || h.keySize != sizeof(T))
+			throw std::runtime_error("tree::load: incompatible key layout");
+
+		// Refuse a count the rest of the stream cannot hold before allocating
+		// for it. A stream that cannot seek is only bounded by the address
+		// space, a short one then fails as truncated.
+		if (h.count > SIZE_MAX / sizeof(Node))
+			throw std::runtime_error("tree::load: key count exceeds stream");
+		std::istream::pos_type at = is.tellg();
+		if (at != std::istream::pos_type(-1))
+		{
+			std::istream::pos_type end = is.seekg(0, std::ios::end).tellg();
+			if (end == std::istream::pos_type(-1) || !is.seekg(at))
+				throw std::runtime_error("tree::load: seek failed");
+			if (static_cast<std::uint64_t>(end - at) / sizeof(T) < h.count)
+				throw std::runtime_error("tree::load: key count exceeds stream");
+		}
+
+		std::size_t n = static_cast<std::size_t>(h.count);
+		std::unique_ptr<T[]> chunk(new T[n < IO_CHUNK ? n : IO_CHUNK]);
+		Node* base = n ? std::allocator<Node>().allocate(n) : nullptr;
+		// Nodes built so far own nothing, releasing the storage suffices.
+		auto fail = [&](const char* what)
+		{
+			if (base)
+				std::allocator<Node>().deallocate(base, n);
+			throw std::runtime_error(what);
+		};
+
+		// Build nodes straight in their in-order slots, checking order.
+		for (std::size_t i = 0; i < n; )
+		{
+			std::size_t m = n - i < IO_CHUNK ? n - i : IO_CHUNK;
+
+			if (!is.read(reinterpret_cast<char*>(chunk.get()), m * sizeof(T)))
+				fail("tree::load: truncated key array");
+			for (std::size_t j = 0; j < m; ++j, ++i)
+			{
+				if (i && chunk[j] < base[i - 1].data)
+					fail("tree::load: keys out of order");
+				new (base + i) Node(chunk[j]);
+			}
+		}
+		std::shared_ptr<Node> block;
+		if (n)
+			block = std::shared_ptr<Node>(base, blockDeleter{ n });
+
+		opScope<Policy> scope(policy(), OP_ADD);
+		policy().rebuild();
+		if (n)
+			policy().allocate();
+
+		std::shared_ptr<Node> top;
+		linkBlock(block, run{ &top, nullptr, 0, n });
+
+		clear();
+		root = top;
+		setEnds();
+		count = n;
+		rebuildFilter();
+	}
 
 	//
 	// Iterators.
@@ -119,203 +587,1343 @@ public:
 	class reverse_iterator;
 	class const_reverse_iterator;
 
-	iterator begin() 
+	iterator begin() { return iterator(edge(false), this); }
+	iterator begin() const { return iterator(edge(false), this); }
+	const_iterator cbegin() const { return begin(); }
+	reverse_iterator rbegin() { return reverse_iterator(edge(true), this); }
+	const_reverse_iterator rbegin() const { return const_reverse_iterator(edge(true), this); }
+
+	iterator end() { return iterator(sentinel(), this); }
+	iterator end() const { return iterator(sentinel(), this); }
+	const_iterator cend() const { return end(); }
+	reverse_iterator rend() { return reverse_iterator(sentinel(), this); }
+	const_reverse_iterator rend() const { return const_reverse_iterator(sentinel(), this); }
+
+	// Insert data, hint being a guess of the element that will follow it.
+	// O(1) (plus finding hint's predecessor) when data belongs right before
+	// hint, end() hints make appends of a growing maximum O(1).
+	iterator insert(iterator hint, T data)
+	{
+		opScope<Policy> scope(policy(), OP_ADD);
+		std::shared_ptr<Node> next = hint.ptr && hint.ptr != &header ? owner(static_cast<Node*>(hint.ptr)) : nullptr;
+		std::shared_ptr<Node> prev = next ? predecessor(next) : rightmost();
+
+		std::shared_ptr<Node> node = fits(prev, next, data) ? attach(prev, next, data) : insertFrom(next ? next : prev, data);
+		autoBalanceCheck();
+		return iterator(node.get(), this);
+	}
+
+	// Insert data unless an equal element is present, in a single descent,
+	// or none when data belongs at the insert finger. Returns the position
+	// of the element equal to data and true if it was inserted.
+	std::pair<iterator, bool> insert_unique(T data) { return emplace_unique(data, [&]() -> T& { return data; }); }
+
+	// insert_unique for a key of any type ordered against T (key < T,
+	// T < key and key == T), e.g. the key part of a key value pair. make()
+	// builds the element, called only if no element equals key.
+	template <class Key, class Make>
+	std::pair<iterator, bool> emplace_unique(const Key& key, Make make)
+	{
+		opScope<Policy> scope(policy(), OP_ADD);
+		// Before the insert, a swap would invalidate the result.
+		rebalanceTick();
+
+		std::shared_ptr<Node> node;
+		if (fingerValid && fits(fingerPrev, fingerNext, key))
+		{
+			if (key == fingerPrev->data)
+				return std::make_pair(iterator(fingerPrev.get(), this), false);
+			auto&& data = make();
+			node = attach(fingerPrev, fingerNext, data);
+		}
+		else
+		{
+			Node* parent = nullptr, *next = nullptr, *at = root.get();
+			std::size_t depth = 1;
+			bool left = false;
+
+			while (at)
+			{
+				policy().visit();
+				policy().compare();
+				if (key == at->data)
+					return std::make_pair(iterator(at, this), false);
+
+				policy().compare();
+				parent = at;
+				left = key < at->data;
+				if (left)
+					next = at;
+				at = left ? at->left.get() : at->right.get();
+				depth++;
+			}
+			auto&& data = make();
+			node = link(parent ? owner(parent) : nullptr, left, next ? owner(next) : nullptr, data, depth);
+		}
+
+		autoBalanceCheck();
+		return std::make_pair(iterator(node.get(), this), true);
+	}
+
+	// Remove the element at pos without a descent. Returns the position of
+	// the element that followed it. Invalidates pos and, when pos has two
+	// children, the iterators to that next element, whose data moves into
+	// pos's node.
+	iterator erase(iterator pos)
+	{
+		opScope<Policy> scope(policy(), OP_REMOVE);
+		resetFinger();
+		generation++;
+
+		Node* node = static_cast<Node*>(pos.ptr);
+		NodeBase* next = node->left && node->right ? node : step<true>(node, policy());
+		unlink(owner(node), true);
+		if (autoBalanceOn)
+			balanceOps++;
+		return iterator(next, this);
+	}
+
+	// First element not less than data, end() if none. One descent. Data
+	// may be of any type T is ordered against (T < data).
+	template <class Key>
+	iterator lower_bound(const Key& data) const
+	{
+		opScope<Policy> scope(policy(), OP_SEARCH);
+		rebalanceTick();
+
+		Node* node = root.get();
+		NodeBase* bound = &header;
+		while (node)
+		{
+			policy().visit();
+			policy().compare();
+			if (node->data < data)
+				node = node->right.get();
+			else
+			{
+				bound = node;
+				node = node->left.get();
+			}
+		}
+		return iterator(bound, this);
+	}
+
+protected:
+	// Binary file header written by save. Fixed width fields, version is
+	// bumped on any layout change.
+	struct fileHeader
+	{
+		char magic[4];
+		std::uint32_t version;
+		std::uint32_t byteOrder; // FILE_BYTE_ORDER as written by the saving host.
+		std::uint32_t keySize;   // sizeof(T).
+		std::uint64_t count;
+	};
+	static const char* fileMagic() { return "BSTK"; }
+	static constexpr std::uint32_t FILE_VERSION = 1;
+	static constexpr std::uint32_t FILE_BYTE_ORDER = 0x01020304;
+	// Keys buffered per stream read/write.
+	static constexpr std::size_t IO_CHUNK = 4096;
+	// Incremental rebalancing copies keys, so it is off for move-only T.
+	static constexpr bool KEYS_COPYABLE = std::is_copy_constructible<T>::value;
+	// Descents interleaved by search_many.
+	static constexpr std::size_t SEARCH_GROUP = 16;
+	// Smallest key capacity the filter is sized for.
+	static constexpr std::size_t FILTER_MIN_KEYS = 1024;
+
+	// Tree root node.
+	std::shared_ptr<Node> root;
+	// Sentinel above the root and end() of the iterators, the only node
+	// without a parent. Its left and right links do not own, they point at
+	// the leftmost and rightmost nodes, empty when the tree is. Mutable as
+	// iterators of a const tree point at it too.
+	mutable NodeBase header;
+	// Number of nodes.
+	std::size_t count;
+
+	// Insert position finger: the last inserted node and its in-order
+	// successor (nullptr when it is the maximum). Valid only while no other
+	// structural change has happened since that insert.
+	std::shared_ptr<Node> fingerPrev, fingerNext;
+	bool fingerValid = false;
+
+	// Optional negative lookup filter, disabled while filterRate is 0. It
+	// is sized for filterKeys keys and rebuilt at twice the size when the
+	// tree outgrows it, so adds stay amortized O(1).
+	bloomFilter filter;
+	double filterRate = 0.0;
+	std::size_t filterKeys = 0;
+
+	// Hot key cache, disabled while cacheSlots is 0. An entry is valid
+	// only if it carries the current generation, bumped by every change
+	// that moves keys between nodes or frees nodes.
+	struct cacheEntry
+	{
+		T key;
+		const Node* node;
+		std::uint64_t generation = 0;
+	};
+	mutable std::unique_ptr<cacheEntry[]> cache;
+	std::size_t cacheSlots = 0;
+	unsigned cacheShift = 64;
+	std::uint64_t generation = 1;
+	mutable cacheCounters cacheCounts = cacheCounters{ 0, 0 };
+
+	// Automatic rebalancing, off unless enabled. fingerDepth holds the
+	// levels down to fingerPrev, 0 when unknown, balanceOps the adds and
+	// removes since the last rebuild, balanceSize the size then.
+	autoBalanceKnobs balanceKnobs;
+	bool autoBalanceOn = false;
+	std::size_t fingerDepth = 0;
+	std::size_t balanceOps = 0;
+	std::size_t balanceSize = 0;
+	std::uint64_t autoBalanceCount = 0;
+
+	// Fibonacci hashing, spreads identity hashes of small integers.
+	std::size_t cacheSlot(const T& data) const
+	{
+		return cacheShift == 64 ? 0 : static_cast<std::size_t>((bloomHash(data) * 0x9E3779B97F4A7C15ull) >> cacheShift);
+	}
+
+	bool cachedSearch(const T& data) const
 	{
-		std::shared_ptr<Node> ptr = root;
+		cacheEntry& e = cache[cacheSlot(data)];
+
+		if (e.generation == generation && e.key == data)
+		{
+			cacheCounts.hits++;
+			return true;
+		}
+
+		cacheCounts.misses++;
+		if (filterRejects(data))
+			return false;
+
+		const Node* node = lookup(data);
+		if (node)
+		{
+			e.key = node->data;
+			e.node = node;
+			e.generation = generation;
+		}
+		return node != nullptr;
+	}
+
+	// Descent on raw pointers, the node holding data or nullptr.
+	const Node* lookup(const T& data) const
+	{
+		const Node* node = root.get();
+
+		while (node && !(data == node->data))
+		{
+			policy().visit();
+			policy().compare();
+			node = data < node->data ? node->left.get() : node->right.get();
+		}
+		return node;
+	}
+
+	bool filterRejects(const T& data) const
+	{
+		return filterRate > 0.0 && !filter.mayContain(bloomHash(data));
+	}
+
+	void filterAdd(const T& data)
+	{
+		if (filterRate == 0.0)
+			return;
+		if (count > filterKeys)
+			rebuildFilter();
+		else
+			filter.add(bloomHash(data));
+	}
+
+	// Size for twice the current keys and add them all, dropping the bits
+	// of removed keys.
+	void rebuildFilter()
+	{
+		if (filterRate == 0.0)
+			return;
+
+		filterKeys = 2 * count < FILTER_MIN_KEYS ? FILTER_MIN_KEYS : 2 * count;
+		filter.reset(filterKeys, filterRate);
+
+		Stack<const Node*> stack;
+		if (root)
+			stack.push(root.get());
+		while (!stack.empty())
+		{
+			const Node* node = stack.pop();
+			filter.add(bloomHash(node->data));
+			if (node->left)
+				stack.push(node->left.get());
+			if (node->right)
+				stack.push(node->right.get());
+		}
+	}
+
+	void clearFilter()
+	{
+		if (filterRate == 0.0)
+			return;
+
+		filterKeys = FILTER_MIN_KEYS;
+		filter.reset(filterKeys, filterRate);
+	}
+
+	void resetFinger()
+	{
+		fingerPrev.reset();
+		fingerNext.reset();
+		fingerValid = false;
+		fingerDepth = 0;
+	}
+
+	// After an insert, the new node being fingerPrev: if it landed deeper
+	// than log(size) base 1/alpha, alpha = 2^(-1/depthFactor), some
+	// ancestor holds more than alpha of its subtree on one side. Climb to
+	// the first such one, the scapegoat, whose rebuild also brings the new
+	// node back within the bound (a long path left by minSize or spacing
+	// takes more than the lowest one), summing subtree sizes on the way,
+	// and rebuild it. The climb costs the size of the subtree rebuilt, so
+	// rebuilds stay O(log n) amortized per insert.
+	void autoBalanceCheck()
+	{
+		if (!autoBalanceOn || ++balanceOps < balanceKnobs.spacing * balanceSize || count < balanceKnobs.minSize)
+			return;
+
+		// Measure the depth when the insert could not track it.
+		if (!fingerDepth)
+			fingerDepth = levelsOf(fingerPrev.get());
+
+		// Depths count edges, fingerDepth counts levels.
+		const double bound = balanceKnobs.depthFactor * std::log2(static_cast<double>(count));
+		std::size_t depth = fingerDepth - 1;
+		if (depth <= bound)
+			return;
+
+		const double alpha = std::pow(2.0, -1.0 / balanceKnobs.depthFactor);
+		Node* node = fingerPrev.get();
+		std::size_t size = 1;
+		for (Node* parent = parentNode(node); parent; parent = parentNode(node))
+		{
+			std::size_t below = size;
+			size += 1 + subtreeSize(parent->left.get() == node ? parent->right.get() : parent->left.get());
+			node = parent;
+			depth--;
+			if (below > alpha * size && depth + std::floor(std::log2(static_cast<double>(size))) <= bound)
+				break;
+		}
+
+		rebuildSubtree(owner(node), size);
+		balanceOps = 0;
+		balanceSize = count;
+		autoBalanceCount++;
+	}
+
+	// Nodes below and including node, iteratively.
+	std::size_t subtreeSize(const Node* node) const
+	{
+		Stack<const Node*> stack;
+		std::size_t n = 0;
+
+		if (node)
+			stack.push(node);
+		while (!stack.empty())
+		{
+			node = stack.pop();
+			policy().visit();
+			n++;
+			if (node->left)
+				stack.push(node->left.get());
+			if (node->right)
+				stack.push(node->right.get());
+		}
+		return n;
+	}
+
+	// Relink the n nodes of the subtree at top as a perfectly balanced one.
+	// Nodes and keys stay, so iterators, the finger and cache entries remain
+	// valid; only the finger's depth is measured again.
+	void rebuildSubtree(std::shared_ptr<Node> top, std::size_t n)
+	{
+		policy().rebuild();
+
+		std::shared_ptr<Node> parent = parentOf(top.get());
+		bool isLeft = parent && parent->left == top;
+
+		Vector<std::shared_ptr<Node>> nodes;
+		nodes.reserve(n);
+		Stack<std::shared_ptr<Node>> stack;
+		for (std::shared_ptr<Node> node = top; node || !stack.empty(); node = node->right)
+		{
+			for (; node; node = node->left)
+				stack.push(node);
+			node = stack.pop();
+			nodes.push_back(node);
+		}
+
+		std::shared_ptr<Node> sub = relink(nodes, parent);
+		if (!parent)
+		{
+			root = sub;
+			sub->parent = &header;
+		}
+		else if (isLeft)
+			parent->left = sub;
+		else
+			parent->right = sub;
+
+		fingerDepth = levelsOf(fingerPrev.get());
+	}
+
+	// Balanced subtree of nodes below parent. Ranges still to be linked
+	// wait on a stack with the link they fill, no recursion.
+	static std::shared_ptr<Node> relink(Vector<std::shared_ptr<Node>>& nodes, const std::shared_ptr<Node>& parent)
+	{
+		struct range
+		{
+			int start, end;
+			Node* parent;
+			std::shared_ptr<Node>* link;
+		};
+
+		std::shared_ptr<Node> sub;
+		Stack<range> ranges;
+		ranges.push(range{ 0, static_cast<int>(nodes.size()) - 1, parent.get(), &sub });
+		while (!ranges.empty())
+		{
+			range r = ranges.pop();
+			if (r.start > r.end)
+			{
+				r.link->reset();
+				continue;
+			}
+
+			int mid = (r.start + r.end) / 2;
+			std::shared_ptr<Node>& node = nodes[mid];
+
+			node->parent = r.parent;
+			*r.link = node;
+			ranges.push(range{ r.start, mid - 1, node.get(), &node->left });
+			ranges.push(range{ mid + 1, r.end, node.get(), &node->right });
+		}
+
+		return sub;
+	}
+
+private:
+	// Leftmost (or rightmost) node, the header if empty. O(1).
+	NodeBase* edge(bool right) const
+	{
+		opScope<Policy> scope(policy(), OP_BEGIN);
+		Node* node = right ? header.right.get() : header.left.get();
+
+		return node ? node : &header;
+	}
+
+	// The header, end() of the iterators. O(1), reported as edge() is.
+	NodeBase* sentinel() const
+	{
+		opScope<Policy> scope(policy(), OP_BEGIN);
+		return &header;
+	}
+
+	// The link owning node, root for the root.
+	const std::shared_ptr<Node>& owner(const Node* node) const
+	{
+		const NodeBase* parent = node->parent;
+
+		if (parent == &header)
+			return root;
+		return parent->left.get() == node ? parent->left : parent->right;
+	}
+	std::shared_ptr<Node>& owner(const Node* node) { return const_cast<std::shared_ptr<Node>&>(static_cast<const tree*>(this)->owner(node)); }
+
+	// Owning link to node's parent, nullptr for the root (or the top of a
+	// tree being built apart, the shadow of an incremental rebalance).
+	std::shared_ptr<Node> parentOf(const Node* node) const
+	{
+		Node* parent = parentNode(node);
+
+		return parent ? owner(parent) : nullptr;
+	}
+
+	// Node's parent, nullptr for the root (the header is no node) or the
+	// top of a tree being built apart.
+	Node* parentNode(const Node* node) const
+	{
+		return node->parent == &header ? nullptr : static_cast<Node*>(node->parent);
+	}
+
+	// Levels from the root down to node, 0 for nullptr.
+	std::size_t levelsOf(const Node* node) const
+	{
+		std::size_t n = 0;
+
+		for (; node; node = parentNode(node))
+			n++;
+		return n;
+	}
+
+	// Non-owning link to node, for the header.
+	static std::shared_ptr<Node> unowned(Node* node) { return std::shared_ptr<Node>(std::shared_ptr<Node>(), node); }
+
+	// Hang root below the header and point the header at the leftmost and
+	// rightmost nodes, after root was replaced or grown wholesale. O(height).
+	void setEnds()
+	{
+		header.left.reset();
+		header.right.reset();
+		if (!root)
+			return;
+
+		root->parent = &header;
+		Node* node = root.get();
+		while (node->left)
+			node = node->left.get();
+		header.left = unowned(node);
+		for (node = root.get(); node->right; )
+			node = node->right.get();
+		header.right = unowned(node);
+	}
+
+	// Move the header's links off target before it is unlinked, target
+	// having at most one child.
+	void releaseEnds(const Node* target)
+	{
+		Node* parent = parentNode(target);
+
+		if (target == header.left.get())
+		{
+			Node* node = target->right ? target->right.get() : parent;
+			while (node && node != parent && node->left)
+				node = node->left.get();
+			header.left = unowned(node);
+		}
+		if (target == header.right.get())
+		{
+			Node* node = target->left ? target->left.get() : parent;
+			while (node && node != parent && node->right)
+				node = node->right.get();
+			header.right = unowned(node);
+		}
+	}
+
+	// Next node in order for iterators (the previous one if !Forward), on
+	// raw pointers. The header closes the ring: stepping off either end
+	// reaches it, stepping from it reaches the minimum (maximum).
+	template <bool Forward>
+	static NodeBase* step(NodeBase* node, const Policy& policy)
+	{
+		if (!node->parent)
+		{
+			NodeBase* edge = (Forward ? node->left : node->right).get();
+			return edge ? edge : node;
+		}
+
+		if (Forward ? node->right : node->left)
+		{
+			node = (Forward ? node->right : node->left).get();
+			policy.visit();
+			while (Forward ? node->left : node->right)
+			{
+				node = (Forward ? node->left : node->right).get();
+				policy.visit();
+			}
+			return node;
+		}
+
+		NodeBase* before;
+		do {
+			before = node;
+			node = node->parent;
+			policy.visit();
+		} while (node->parent && before == (Forward ? node->right : node->left).get());
+		return node;
+	}
+
+	// Internal method to clone subtree, iteratively.
+	static std::shared_ptr<Node> clone(std::shared_ptr<Node> t)
+	{
+		if (t == nullptr)
+			return nullptr;
+
+		std::shared_ptr<Node> copy = std::make_shared<Node>(t->data);
+		Stack<std::shared_ptr<Node>> src, dst;
+
+		src.push(t);
+		dst.push(copy);
+		while (!src.empty())
+		{
+			std::shared_ptr<Node> from = src.pop(), to = dst.pop();
+
+			if (from->left)
+			{
+				to->left = std::make_shared<Node>(to, from->left->data);
+				src.push(from->left);
+				dst.push(to->left);
+			}
+			if (from->right)
+			{
+				to->right = std::make_shared<Node>(to, from->right->data);
+				src.push(from->right);
+				dst.push(to->right);
+			}
+		}
+
+		return copy;
+	}
+
+	// Delete all nodes of tree.
+	void clear(std::shared_ptr<Node>& node) { destroy(node); }
+
+	// Release subtree in O(n) without recursion. Left children are rotated
+	// up until the current node has none, then it is released and its right
+	// child visited. Nodes still referenced elsewhere (iterators) survive.
+	// Stops after budget steps, the rest left in node, returns the steps.
+	static std::size_t destroy(std::shared_ptr<Node>& node, std::size_t budget = SIZE_MAX)
+	{
+		std::size_t steps = 0;
+
+		for (; node && steps < budget; steps++)
+		{
+			if (node->left)
+			{
+				std::shared_ptr<Node> l = std::move(node->left);
+				node->left = std::move(l->right);
+				l->right = std::move(node);
+				node = std::move(l);
+			}
+			else
+			{
+				std::shared_ptr<Node> r = std::move(node->right);
+				node = std::move(r);
+			}
+		}
+		return steps;
+	}
+
+	// Add new node to tree, trying the finger before searching.
+	std::shared_ptr<Node> insertNear(T& data)
+	{
+		if (!fingerValid)
+			return insertFrom(nullptr, data);
+
+		if (fits(fingerPrev, fingerNext, data))
+			return attach(fingerPrev, fingerNext, data);
+
+		return insertFrom(fingerNext && !(data < fingerNext->data) ? fingerNext : fingerPrev, data);
+	}
+
+	// True if data belongs between adjacent nodes prev and next.
+	template <class Key>
+	static bool fits(const std::shared_ptr<Node>& prev, const std::shared_ptr<Node>& next, const Key& data)
+	{
+		return (!prev || !(data < prev->data)) && (!next || data < next->data);
+	}
+
+	// Link new node between adjacent nodes prev and next. One of prev's
+	// right or next's left link is always free.
+	std::shared_ptr<Node> attach(std::shared_ptr<Node> prev, std::shared_ptr<Node> next, T& data)
+	{
+		if (prev && !prev->right)
+			return link(prev, false, next, data, levels(prev) ? levels(prev) + 1 : 0);
+		else if (next)
+			return link(next, true, next, data, levels(next) ? levels(next) + 1 : 0);
+		else
+			return link(nullptr, false, nullptr, data, 1);
+	}
+
+	// Levels down to node if known, 0 otherwise. Only the finger's are.
+	std::size_t levels(const std::shared_ptr<Node>& node) const { return node == fingerPrev ? fingerDepth : 0; }
+
+	// Create node as child of parent (root if parent is nullptr), next being
+	// its in-order successor, depth its levels from the root (0 unknown).
+	// Data is moved into the node.
+	std::shared_ptr<Node> link(std::shared_ptr<Node> parent, bool left, std::shared_ptr<Node> next, T& data, std::size_t depth = 0)
+	{
+		std::shared_ptr<Node> node = std::make_shared<Node>(parent, std::move(data));
+
+		policy().allocate();
+		++count;
+		if (!parent)
+		{
+			root = node;
+			node->parent = &header;
+		}
+		else if (left)
+			parent->left = node;
+		else
+			parent->right = node;
+		if (!parent || (left && parent.get() == header.left.get()))
+			header.left = unowned(node.get());
+		if (!parent || (!left && parent.get() == header.right.get()))
+			header.right = unowned(node.get());
+		filterAdd(node->data);
+		rebalanceLog(node, true);
+
+		fingerPrev = node;
+		fingerNext = next;
+		fingerValid = true;
+		fingerDepth = depth;
+
+		return node;
+	}
+
+	// Insert data searching from start (or root), climbing parent links
+	// until the subtree below must contain data, then descending. Depth is
+	// tracked relative to start, and becomes exact if the climb reaches
+	// the root.
+	std::shared_ptr<Node> insertFrom(std::shared_ptr<Node> start, T& data)
+	{
+		std::shared_ptr<Node> node = start ? start : root, next = nullptr;
+		std::size_t depth = start ? levels(start) : 1;
+		bool top = true;
+
+		if (!node)
+			return link(nullptr, false, nullptr, data, 1);
+
+		for (std::shared_ptr<Node> parent = parentOf(node.get()); parent; parent = parentOf(node.get()))
+		{
+			bool isLeft = parent->left == node;
+
+			policy().visit();
+			policy().compare();
+
+			if (data < node->data)
+			{
+				// Lower bound known when node hangs right of a smaller parent.
+				if (!isLeft && !(data < parent->data))
+				{
+					top = false;
+					break;
+				}
+			}
+			else if (isLeft && data < parent->data)
+			{
+				// Upper bound known, the parent follows everything below.
+				next = parent;
+				top = false;
+				break;
+			}
+			node = parent;
+			if (depth)
+				depth--;
+		}
+		if (top)
+			depth = 1;
+
+		// Smaller data goes left, equal or larger goes right.
+		while (true)
+		{
+			policy().visit();
+			policy().compare();
+			if (data < node->data)
+			{
+				next = node;
+				if (!node->left)
+					return link(node, true, next, data, depth ? depth + 1 : 0);
+				node = node->left;
+			}
+			else
+			{
+				if (!node->right)
+					return link(node, false, next, data, depth ? depth + 1 : 0);
+				node = node->right;
+			}
+			if (depth)
+				depth++;
+		}
+	}
+
+	// In-order predecessor of node, nullptr if node is the minimum.
+	std::shared_ptr<Node> predecessor(std::shared_ptr<Node> node) const
+	{
+		if (node->left)
+		{
+			node = node->left;
+			while (node->right)
+				node = node->right;
+			return node;
+		}
 
-		while (ptr->left)
-			ptr = ptr->left;
+		std::shared_ptr<Node> before;
+		do {
+			before = node;
+			node = parentOf(node.get());
+		} while (node && before == node->left);
 
-		return iterator(ptr);
+		return node;
 	}
-	const iterator begin() const
+
+	// In-order successor of node, nullptr if node is the maximum.
+	std::shared_ptr<Node> successor(std::shared_ptr<Node> node) const
 	{
-		std::shared_ptr<Node> ptr = root;
+		if (node->right)
+		{
+			node = node->right;
+			policy().visit();
+			while (node->left)
+			{
+				node = node->left;
+				policy().visit();
+			}
+			return node;
+		}
 
-		while (ptr->left)
-			ptr = ptr->left;
+		std::shared_ptr<Node> before;
+		do {
+			before = node;
+			node = parentOf(node.get());
+			policy().visit();
+		} while (node && before == node->right);
 
-		return iterator(ptr);
+		return node;
 	}
-	const_iterator cbegin() const { return begin(); }
-	reverse_iterator rbegin()
-	{
-		std::shared_ptr<Node> ptr = root;
 
-		while (ptr->right)
-			ptr = ptr->right;
+	// True if a comes before b in order, a != b, comparing their paths
+	// from the root. For nodes of equal keys.
+	bool precedes(const Node* a, const Node* b) const
+	{
+		Vector<const Node*> pa, pb;
+		for (; a; a = parentNode(a))
+			pa.push_back(a);
+		for (; b; b = parentNode(b))
+			pb.push_back(b);
+
+		// Skip the common part, pa[i] and pb[j] are then the last shared node.
+		std::size_t i = pa.size() - 1, j = pb.size() - 1;
+		while (i && j && pa[i - 1] == pb[j - 1])
+		{
+			i--;
+			j--;
+		}
 
-		return reverse_iterator(ptr);
+		if (!i)
+			return pb[j - 1] == pa[0]->right.get(); // a above b.
+		if (!j)
+			return pa[i - 1] == pb[0]->left.get();  // b above a.
+		return pa[i - 1] == pa[i]->left.get();
 	}
-	const_reverse_iterator rbegin() const
+
+	// Rightmost (maximum) node, O(1) through the header.
+	std::shared_ptr<Node> rightmost() const { return header.right ? owner(header.right.get()) : nullptr; }
+
+	// Sort keys. Ascending runs already present are merged pairwise, in
+	// O(n log r) for r runs, unless there are too many to pay off.
+	static void sortRuns(T* keys, std::size_t n)
 	{
-		std::shared_ptr<Node> ptr = root;
+		Vector<std::size_t> bounds;
+
+		bounds.push_back(0);
+		for (std::size_t i = 1; i < n; i++)
+			if (keys[i] < keys[i - 1])
+			{
+				bounds.push_back(i);
+				if (bounds.size() > n / 32 + 1)
+				{
+					std::sort(keys, keys + n);
+					return;
+				}
+			}
+		bounds.push_back(n);
 
-		while (ptr->right)
-			ptr = ptr->right;
+		while (bounds.size() > 2)
+		{
+			Vector<std::size_t> merged;
+			std::size_t i = 0;
+
+			for (; i + 2 < bounds.size(); i += 2)
+			{
+				std::inplace_merge(keys + bounds[i], keys + bounds[i + 1], keys + bounds[i + 2]);
+				merged.push_back(bounds[i]);
+			}
+			for (; i < bounds.size(); i++)
+				merged.push_back(bounds[i]);
 
-		return const_reverse_iterator(ptr);
+			bounds = merged;
+		}
 	}
 
-	iterator end()
+	// Pending run of sorted keys and the link it descends into.
+	struct run
 	{
-		std::shared_ptr<Node> ptr = root;
-
-		while (ptr->right)
-			ptr = ptr->right;
-		
-		return iterator(ptr->right); // return iterator(nullptr);
+		std::shared_ptr<Node>* link;
+		std::shared_ptr<Node> parent;
+		std::size_t lo, hi;
+	};
+
+	// Incremental rebalance (rebalance_start). Keys before rebalanceCursor
+	// are copied to rebalanceKeys, then linked into rebalanceShadow. Changes
+	// reaching the copied part are logged, then replayed into the shadow,
+	// which then takes the place of root. rebalanceBefore counts the live
+	// nodes before the cursor, so the copy ends without climbing from the
+	// maximum. Old trees wait in rebalanceRetired to be released.
+	enum rebalanceState { REBALANCE_IDLE, REBALANCE_COLLECT, REBALANCE_BUILD, REBALANCE_REPLAY };
+	struct rebalanceChange
+	{
+		T key;
+		bool add;
+	};
+	rebalanceState rebalancePhase = REBALANCE_IDLE;
+	std::size_t rebalancePerOp = 0;
+	std::shared_ptr<Node> rebalanceCursor;
+	std::size_t rebalanceBefore = 0;
+	Vector<T> rebalanceKeys;
+	Vector<run> rebalanceRuns;
+	std::shared_ptr<Node> rebalanceShadow;
+	Vector<rebalanceChange> rebalanceChanges;
+	std::size_t rebalanceReplayed = 0;
+	Vector<std::shared_ptr<Node>> rebalanceRetired;
+
+	// One operation's slice of the work. Const so searches take part: only
+	// a tree reached through a non-const path can have started one.
+	void rebalanceTick() const
+	{
+		if constexpr (KEYS_COPYABLE)
+			if (rebalancePerOp && rebalancing())
+				const_cast<tree*>(this)->rebalanceSteps(rebalancePerOp);
 	}
-	const iterator end() const
+
+	bool rebalanceSteps(std::size_t budget)
 	{
-		std::shared_ptr<Node> ptr = root;
+		while (budget)
+		{
+			switch (rebalancePhase)
+			{
+			case REBALANCE_COLLECT:
+				if (!rebalanceCursor)
+				{
+					rebalancePhase = REBALANCE_BUILD;
+					rebalanceRuns.push_back(run{ &rebalanceShadow, nullptr, 0, rebalanceKeys.size() });
+					break;
+				}
+				rebalanceKeys.push_back(rebalanceCursor->data);
+				rebalanceCursor = ++rebalanceBefore == count ? nullptr : successor(rebalanceCursor);
+				budget--;
+				break;
 
-		while (ptr->right)
-			ptr = ptr->right;
+			case REBALANCE_BUILD:
+				if (!rebalanceRuns.size())
+				{
+					rebalancePhase = REBALANCE_REPLAY;
+					rebalanceKeys.clear();
+					break;
+				}
+				budget -= buildRuns(rebalanceKeys.size() ? &rebalanceKeys[0] : nullptr, rebalanceRuns, budget);
+				break;
 
-		return iterator(ptr->right);
+			case REBALANCE_REPLAY:
+				if (rebalanceReplayed == rebalanceChanges.size())
+				{
+					rebalanceSwap();
+					break;
+				}
+				else
+				{
+					rebalanceChange& c = rebalanceChanges[rebalanceReplayed++];
+					if (c.add)
+						shadowInsert(c.key);
+					else
+						remove(rebalanceShadow, c.key, false);
+					budget--;
+				}
+				break;
+
+			case REBALANCE_IDLE:
+				if (!rebalanceRetired.size())
+					return false;
+				budget -= destroy(rebalanceRetired[rebalanceRetired.size() - 1], budget);
+				if (!rebalanceRetired[rebalanceRetired.size() - 1])
+					rebalanceRetired.pop_back();
+				break;
+			}
+		}
+		return rebalancing();
 	}
-	const_iterator cend() const { return end(); }
-	reverse_iterator rend()
-	{
-		std::shared_ptr<Node> ptr = root;
 
-		while (ptr->left)
-			ptr = ptr->left;
+	// The shadow holds every key, make it the tree.
+	void rebalanceSwap()
+	{
+		policy().rebuild();
+		rebalanceRetired.push_back(root);
+		root = rebalanceShadow;
+		setEnds();
+		rebalanceShadow.reset();
+		rebalanceCursor.reset();
+		rebalanceBefore = 0;
+		rebalanceChanges.clear();
+		rebalanceReplayed = 0;
+		rebalancePhase = REBALANCE_IDLE;
+
+		// Nodes moved, as after balance().
+		resetFinger();
+		generation++;
+		balanceOps = 0;
+		balanceSize = count;
+	}
 
-		return reverse_iterator(ptr->left);
+	// Abandon a rebalance in progress, releasing its nodes now or in later
+	// steps.
+	void rebalanceCancel(bool release)
+	{
+		if (rebalanceShadow)
+			rebalanceRetired.push_back(rebalanceShadow);
+		rebalanceShadow.reset();
+		rebalanceCursor.reset();
+		rebalanceBefore = 0;
+		rebalanceKeys.clear();
+		rebalanceRuns.clear();
+		rebalanceChanges.clear();
+		rebalanceReplayed = 0;
+		rebalancePhase = REBALANCE_IDLE;
+
+		if (release)
+		{
+			for (std::size_t i = 0; i < rebalanceRetired.size(); i++)
+				destroy(rebalanceRetired[i]);
+			rebalanceRetired.clear();
+		}
 	}
-	const_reverse_iterator rend() const
+
+	// True if live node comes before the copy cursor, its key copied.
+	bool beforeCursor(const std::shared_ptr<Node>& node) const
 	{
-		std::shared_ptr<Node> ptr = root;
+		if (!rebalanceCursor || node->data < rebalanceCursor->data)
+			return true;
+		if (rebalanceCursor->data < node->data || node == rebalanceCursor)
+			return false;
+		return precedes(node.get(), rebalanceCursor.get());
+	}
 
-		while (ptr->left)
-			ptr = ptr->left;
+	// Log a live node added or removed once the copy would miss it.
+	void rebalanceLog(const std::shared_ptr<Node>& node, bool add)
+	{
+		if (rebalancePhase != REBALANCE_IDLE && (rebalancePhase != REBALANCE_COLLECT || beforeCursor(node)))
+			rebalanceNote(node->data, add);
+	}
 
-		return const_reverse_iterator(ptr->left);
+	void rebalanceNote(const T& key, bool add)
+	{
+		// Unreachable for move-only T, which cannot start a rebalance.
+		if constexpr (KEYS_COPYABLE)
+		{
+			rebalanceChanges.push_back(rebalanceChange{ key, add });
+			if (rebalancePhase != REBALANCE_COLLECT)
+				return;
+			if (add)
+				rebalanceBefore++;
+			else
+				rebalanceBefore--;
+		}
 	}
 
-protected:
-	// Tree root node.
-	std::shared_ptr<Node> root;
+	// Live remove of found's key, target being the node unlinked (found's
+	// successor, when found has two children). Logs a key already copied
+	// and keeps the cursor on a linked node.
+	void rebalanceRemoving(const std::shared_ptr<Node>& found, const std::shared_ptr<Node>& target)
+	{
+		if (rebalancePhase != REBALANCE_COLLECT)
+		{
+			rebalanceLog(found, false);
+			return;
+		}
 
-private:
-	// Internal method to clone subtree.
-	std::shared_ptr<Node> clone(std::shared_ptr<Node> t)
+		if (target == rebalanceCursor)
+		{
+			// found takes over target's key, or the next node is copied next.
+			if (found != target)
+				rebalanceNote(found->data, false);
+			rebalanceCursor = found != target ? found : successor(target);
+		}
+		else
+			rebalanceLog(found, false);
+	}
+
+	// Plain descent insert into the shadow tree, equal keys going right.
+	void shadowInsert(const T& data)
 	{
-		if (t == nullptr)
-			return nullptr;
-		return std::make_shared<Node>(Node(t->element, clone(t->left), clone(t->right)));
+		std::shared_ptr<Node>* link = &rebalanceShadow;
+		std::shared_ptr<Node> parent;
+
+		while (*link)
+		{
+			policy().visit();
+			policy().compare();
+			parent = *link;
+			link = data < parent->data ? &parent->left : &parent->right;
+		}
+		*link = std::make_shared<Node>(parent, data);
+		policy().allocate();
 	}
 
-	// Delete all nodes of tree.
-	void clear(std::shared_ptr<Node>& node)
+	// Merge sorted keys into tree, splitting runs at each node on the way down.
+	void insertRuns(const T* keys, std::size_t n)
 	{
-		if (!node)
-			return;
+		Vector<run> runs;
+		runs.push_back(run{ &root, nullptr, 0, n });
 
-		if (node->left)
-			clear(node->left);
+		while (runs.size())
+		{
+			run r = runs[runs.size() - 1];
+			runs.pop_back();
 
-		if (node->right)
-			clear(node->right);
+			if (r.lo == r.hi)
+				continue;
 
-		node.reset(); //node.~shared_ptr();
+			std::shared_ptr<Node> node = *r.link;
+			if (!node)
+			{
+				buildRun(keys, r);
+				count += r.hi - r.lo;
+				continue;
+			}
+
+			// Smaller keys go left, equal or larger keys go right (as add does).
+			policy().visit();
+			std::size_t mid = std::lower_bound(keys + r.lo, keys + r.hi, node->data) - keys;
+			runs.push_back(run{ &node->left, node, r.lo, mid });
+			runs.push_back(run{ &node->right, node, mid, r.hi });
+		}
 	}
 
-	// Add new node to tree.
-	void add(std::shared_ptr<Node>& node, std::shared_ptr<Node> parentNode, T& data)
+	// Build balanced subtree from sorted keys [r.lo, r.hi) into r.link.
+	// Iterative, as runs of duplicates degenerate into right leaning chains.
+	void buildRun(const T* keys, run r)
 	{
-		if (!node)
-			node = std::make_shared<Node>(parentNode, data);
-		else
-			data < node->data ? add(node->left, node, data) : add(node->right, node, data);
+		Vector<run> runs;
+
+		runs.push_back(r);
+		buildRuns(keys, runs, SIZE_MAX);
 	}
 
-	// Number of nodes in tree.
-	std::size_t size(std::shared_ptr<Node>& node)
+	// Link up to budget nodes of the pending runs, returns the number linked.
+	std::size_t buildRuns(const T* keys, Vector<run>& runs, std::size_t budget)
 	{
-		if (!node)
-			return 0;
-		else
-			return 1 + size(node->left) + size(node->right);
+		std::size_t made = 0;
+
+		while (runs.size() && made < budget)
+		{
+			run r = runs[runs.size() - 1];
+			runs.pop_back();
+
+			if (r.lo >= r.hi)
+				continue;
+
+			// Keep duplicates of the middle key in the right subtree.
+			std::size_t half = r.lo + (r.hi - r.lo) / 2;
+			std::size_t mid = std::lower_bound(keys + r.lo, keys + half, keys[half]) - keys;
+
+			std::shared_ptr<Node> node = std::make_shared<Node>(r.parent, keys[mid]);
+			policy().allocate();
+			*r.link = node;
+			runs.push_back(run{ &node->left, node, r.lo, mid });
+			runs.push_back(run{ &node->right, node, mid + 1, r.hi });
+			made++;
+		}
+		return made;
 	}
 
-	// Return minimum value of either child nodes.
-	T min(std::shared_ptr<Node> node) const
+	// Frees load's node block, n nodes in one allocation.
+	struct blockDeleter
 	{
-		if (node->isLeaf())
-			return node->data;
+		std::size_t n;
 
-		return node->left ? min(node->left) : min(node->right);
+		void operator()(Node* block) const
+		{
+			for (std::size_t i = 0; i < n; i++)
+				block[i].~Node();
+			std::allocator<Node>().deallocate(block, n);
+		}
+	};
+
+	// Link block nodes [r.lo, r.hi), already holding sorted keys, as a
+	// balanced subtree into r.link, iteratively as buildRun. Links alias the
+	// block, which is freed with the last node.
+	static void linkBlock(const std::shared_ptr<Node>& block, run r)
+	{
+		Node* base = block.get();
+		Vector<run> runs;
+
+		runs.push_back(r);
+		while (runs.size())
+		{
+			r = runs[runs.size() - 1];
+			runs.pop_back();
+
+			if (r.lo >= r.hi)
+				continue;
+
+			// Keep duplicates of the middle key in the right subtree.
+			Node* half = base + r.lo + (r.hi - r.lo) / 2;
+			std::size_t mid = std::lower_bound(base + r.lo, half, half->data,
+				[](const Node& a, const T& key) { return a.data < key; }) - base;
+
+			std::shared_ptr<Node> node(block, base + mid);
+			node->parent = r.parent.get();
+			*r.link = node;
+			runs.push_back(run{ &node->left, node, r.lo, mid });
+			runs.push_back(run{ &node->right, node, mid + 1, r.hi });
+		}
 	}
 
-	// Remove first instance of data from tree.
-	bool remove(std::shared_ptr<Node>& node, T data)
+	// Remove first instance of data found descending from node. Not live
+	// for the shadow tree of an incremental rebalance, which is neither
+	// counted nor logged.
+	bool remove(std::shared_ptr<Node>& node, T data, bool live)
 	{
-		if (!node)
+		std::shared_ptr<Node>* link = &node;
+
+		while (*link && !((*link)->data == data))
+		{
+			policy().visit();
+			policy().compare();
+			link = data < (*link)->data ? &(*link)->left : &(*link)->right;
+		}
+
+		if (!*link)
 			return false;
-		else
+
+		unlink(*link, live);
+		return true;
+	}
+
+	// Unlink the node at link, live as for remove.
+	void unlink(std::shared_ptr<Node>& at, bool live)
+	{
+		std::shared_ptr<Node>* link = &at;
+		std::shared_ptr<Node> found = *link, target = found;
+		if (target->left && target->right)
 		{
-			if (node->data == data)
+			// Node has 2 children, take over successor's data and unlink
+			// the successor instead (it has no left child).
+			link = &target->right;
+			while ((*link)->left)
 			{
-				if (node->isLeaf())
-					node.reset();
-				else
-				{
-					if (node->left && node->right)
-					{
-						// Node has 2 children, pick smaller one and replace.
-						T dataReplace = min(node->right);
-						remove(dataReplace);
-						node->data = dataReplace;
-					}
-					else
-					{
-						// 1 child, promote it.
-						std::shared_ptr<Node> nodeReplace, parent;
-						node->left ? nodeReplace = node->left : nodeReplace = node->right;
-						parent = node->parent;
-						node.reset();
-						node = nodeReplace;    // Replace with the only child node.
-						node->parent = parent; // Update parent link.
-					}
-				}
-
-				return true;
+				policy().visit();
+				link = &(*link)->left;
 			}
-
-			return remove(node->left, data) || remove(node->right, data);
+			target = *link;
+		}
+		if (live)
+		{
+			rebalanceRemoving(found, target);
+			releaseEnds(target.get());
 		}
+		if (found != target)
+			found->data = std::move(target->data);
+
+		// 0 or 1 child, promote it.
+		std::shared_ptr<Node> child = target->left ? target->left : target->right;
+		if (child)
+			child->parent = target->parent;
+		target->left.reset();
+		target->right.reset();
+		*link = child;
+		if (live)
+			--count;
 	}
 
-	// Recursively find first occurance of data in tree.
+	// Find first occurance of data in tree, pre-order.
 	bool find(std::shared_ptr<Node> node, T& data) const
 	{
-		if (!node)
-			return false;
-		else
+		Stack<std::shared_ptr<Node>> stack;
+
+		if (node)
+			stack.push(node);
+
+		while (!stack.empty())
 		{
+			node = stack.pop();
+			policy().visit();
+			policy().compare();
+
 			if (node->data == data)
 				return true;
 
-			return find(node->left, data) || find(node->right, data);
+			if (node->right)
+				stack.push(node->right);
+			if (node->left)
+				stack.push(node->left);
 		}
+
+		return false;
 	}
 
 	// Non-recursive search.
 	bool search(std::shared_ptr<Node> node, T& data) const
 	{
 		while (node != nullptr)
+		{
+			policy().visit();
+			policy().compare();
 			if (data == node->data)
 				return true;
-			else if (data < node->data)
+
+			policy().compare();
+			if (data < node->data)
 				node = node->left;
 			else
 				node = node->right;
+		}
 		return false;
 	}
 
+	// Group prefetched search. Descents of SEARCH_GROUP keys advance a
+	// level at a time, each prefetching its next node, so the cache misses
+	// of the group overlap. Raw pointers, no reference count traffic.
+	std::size_t searchMany(const Node* top, const T* keys, std::size_t n, bool* found) const
+	{
+		const Node* cursor[SEARCH_GROUP];
+		std::size_t hits = 0;
+
+		for (std::size_t base = 0; base < n; base += SEARCH_GROUP)
+		{
+			std::size_t group = n - base < SEARCH_GROUP ? n - base : SEARCH_GROUP;
+			std::size_t active = 0;
+
+			for (std::size_t i = 0; i < group; i++)
+			{
+				cursor[i] = filterRejects(keys[base + i]) ? nullptr : top;
+				active += cursor[i] != nullptr;
+				found[base + i] = false;
+			}
+
+			while (active)
+			{
+				active = 0;
+				for (std::size_t i = 0; i < group; i++)
+				{
+					const Node* p = cursor[i];
+					if (p == nullptr)
+						continue;
+
+					const T& key = keys[base + i];
+					policy().visit();
+					policy().compare();
+					if (key == p->data)
+					{
+						found[base + i] = true;
+						hits++;
+						p = nullptr;
+					}
+					else
+						p = key < p->data ? p->left.get() : p->right.get();
+
+					if (p)
+					{
+						prefetch(p);
+						active++;
+					}
+					cursor[i] = p;
+				}
+			}
+		}
+
+		return hits;
+	}
+
 	// Iterative in-order search using a stack.
 	bool iInorderSearch(std::shared_ptr<Node> p, T target) const
 	{
@@ -364,8 +1972,8 @@ private:
 		std::cout << node->data << " ";
 #ifdef _DEBUG
 		std::cout << node->data << "(";
-		if (node->parent)
-			std::cout << node->parent->data << ") ";
+		if (parentNode(node.get()))
+			std::cout << parentNode(node.get())->data << ") ";
 		else
 		    std::cout << "x) ";
 #endif
@@ -500,96 +2108,162 @@ private:
 	// Get height of node. Used by isBalanced function.
 	static int getHeight(std::shared_ptr<Node> node)
 	{
-		return node == nullptr ? 0 : std::max(getHeight(node->left), getHeight(node->right)) + 1;
+		Stack<std::pair<std::shared_ptr<Node>, int>> stack;
+		int height = 0;
+
+		if (node)
+			stack.push(std::make_pair(node, 1));
+
+		while (!stack.empty())
+		{
+			std::pair<std::shared_ptr<Node>, int> top = stack.pop();
+
+			height = std::max(height, top.second);
+			if (top.first->left)
+				stack.push(std::make_pair(top.first->left, top.second + 1));
+			if (top.first->right)
+				stack.push(std::make_pair(top.first->right, top.second + 1));
+		}
+
+		return height;
 	}
 
-	// Check if tree is balanced.
+	// Check if tree is balanced, single post-order pass. Subtree heights
+	// are kept on a second stack as children complete.
 	static bool isBalanced(std::shared_ptr<Node> node)
 	{
-		if (node == nullptr)
-			return true;
+		Stack<std::shared_ptr<Node>> stack;
+		Stack<int> heights;
+		std::shared_ptr<Node> last;
+
+		while (node || !stack.empty())
+		{
+			if (node)
+			{
+				stack.push(node);
+				node = node->left;
+				continue;
+			}
 
-		int left = getHeight(node->left);
-		int right = getHeight(node->right);
+			std::shared_ptr<Node> top = stack.top();
+			if (top->right && top->right != last)
+			{
+				node = top->right;
+				continue;
+			}
+
+			stack.pop();
+			int right = top->right ? heights.pop() : 0;
+			int left = top->left ? heights.pop() : 0;
+
+			if (abs(left - right) > 1)
+				return false;
 
-		return (abs(left - right) <= 1 && isBalanced(node->left) && isBalanced(node->right));
+			heights.push(std::max(left, right) + 1);
+			last = top;
+		}
+
+		return true;
 	}
 
 	// Balance tree helper method, builds tree from (sorted) array of data elements.
-	void buildTree(vector<T>& data, int start, int end)
+	void buildTree(Vector<T>& data, int start, int end)
 	{
 		if (start <= end)
 		{
 			int mid = (start + end) / 2;
 
-			add(data[mid]);
+			insertNear(data[mid]);
 
 			buildTree(data, start, mid - 1);
 			buildTree(data, mid + 1, end);
 		}
 	}
 
-	// Balance tree helper method, constructs sorted array of tree data via inOrder traversal.
-	void makeArray(std::shared_ptr<Node> node, vector<T>& data)
+	// Balance tree helper method, constructs sorted array of tree data via
+	// iterative inOrder traversal.
+	void makeArray(std::shared_ptr<Node> node, Vector<T>& data)
 	{
-		// Base case.
-		if (!node)
-			return;
+		Stack<std::shared_ptr<Node>> stack;
+
+		while (node || !stack.empty())
+		{
+			while (node)
+			{
+				stack.push(node);
+				node = node->left;
+			}
 
-		// Store tree nodes inorder.
-		makeArray(node->left, data);
-		data.push_back(node->data);
-		makeArray(node->right, data);
+			node = stack.pop();
+			policy().visit();
+			data.push_back(node->data);
+			node = node->right;
+		}
 	}
 
 	// Attempt to reconstruct tree as balanced. 
 	void balanceTree(std::shared_ptr<Node> node)
 	{
 		// Store nodes in sorted order.
-		vector<T> data;
+		Vector<T> data;
 		data.reserve(size());
 		makeArray(node, data);
 
-		// Reconstruct a balanced tree.
-		clear(root);
-		buildTree(data, 0, data.size() - 1);
+		// Reconstruct a balanced tree, then the filter once.
+		policy().rebuild();
+		balanceOps = 0;
+		balanceSize = data.size();
+		double rate = filterRate;
+		filterRate = 0.0;
+		clear(); // Invalidates the cache.
+		buildTree(data, 0, static_cast<int>(data.size()) - 1);
+		filterRate = rate;
+		rebuildFilter();
 	}
 };
 
-template <typename T>
-struct tree<T>::Node
+template <typename T, class Policy>
+struct tree<T, Policy>::Node : NodeBase
 {
 private:
 	T data;
-	std::shared_ptr<Node> left = nullptr;
-	std::shared_ptr<Node> right = nullptr;
-	std::shared_ptr<Node> parent = nullptr;
 
 	// Return true if node is leaf.
-	bool isLeaf() const { return !left && !right; }
+	bool isLeaf() const { return !this->left && !this->right; }
 
 public:
-	explicit Node(T d) : data(d) { }
-	Node(std::shared_ptr<Node> p, T d) : parent(p), data(d) { }
-	~Node() = default;
+	explicit Node(T d) : data(std::move(d)) { }
+	Node(const std::shared_ptr<Node>& p, T d) : data(std::move(d)) { this->parent = p.get(); }
+	// Tear down children iteratively, deep subtrees would otherwise
+	// recurse through the shared_ptr destructor chain.
+	~Node()
+	{
+		tree<T, Policy>::destroy(this->left);
+		tree<T, Policy>::destroy(this->right);
+	}
 
-	template <typename T> friend class tree;
+	template <typename U, class P> friend class tree;
 };
 
-template <typename T>
-class tree<T>::iterator
+template <typename T, class Policy>
+class tree<T, Policy>::iterator : public policyRef<Policy>
 {
-	template <typename T> friend class tree;
+	template <typename U, class P> friend class tree;
 
 public:
 	typedef std::bidirectional_iterator_tag iterator_category;
+	typedef T value_type;
+	typedef std::ptrdiff_t difference_type;
+	typedef T* pointer;
+	typedef T& reference;
 
-	iterator() { ptr = nullptr; }
-	iterator(std::shared_ptr<Node> p) { ptr = p; }
-	iterator(const iterator& it) { ptr = it.ptr; }
+	iterator() : ptr(nullptr) { }
+	iterator(NodeBase* p, const Policy* s = nullptr) : policyRef<Policy>(s), ptr(p) { }
+	iterator(const iterator& it) : policyRef<Policy>(it), ptr(it.ptr) { }
 
 	iterator& operator= (const iterator& it)
 	{
+		policyRef<Policy>::operator= (it);
 		ptr = it.ptr;
 		return *this;
 	}
@@ -597,28 +2271,15 @@ public:
 	bool operator== (const iterator& it) const { return ptr == it.ptr; }
 	bool operator!= (const iterator& it) const { return ptr != it.ptr; }
 	bool operator< (const iterator& it) const { return **this < *it; }
-	bool operator> (const iterator& it) const { return **this > * it; }
+	bool operator> (const iterator& it) const { return **this > *it; }
 	bool operator<= (const iterator& it) const { return **this <= *it; }
 	bool operator>= (const iterator& it) const { return **this >= *it; }
 
 	// pre-increment
 	iterator& operator++ ()
 	{
-		if (ptr->right)
-		{
-			ptr = ptr->right;
-			while (ptr->left)
-				ptr = ptr->left;
-		}
-		else
-		{
-			std::shared_ptr<Node> before;
-
-			do {
-				before = ptr;
-				ptr = ptr->parent;
-			} while (ptr && before == ptr->right);
-		}
+		opScope<Policy> scope(this->policyOf(), OP_ITERATE);
+		ptr = step<true>(ptr, this->policyOf());
 		return *this;
 	}
 	// post-increment
@@ -632,21 +2293,8 @@ public:
 	// pre-decrement
 	iterator& operator-- ()
 	{
-		if (ptr->left)
-		{
-			ptr = ptr->left;
-			while (ptr->right) {
-				ptr = ptr->right;
-			}
-		}
-		else
-		{
-			std::shared_ptr<Node> before;
-			do {
-				before = ptr;
-				ptr = ptr->parent;
-			} while (ptr && before == ptr->left);
-		}
+		opScope<Policy> scope(this->policyOf(), OP_ITERATE);
+		ptr = step<false>(ptr, this->policyOf());
 		return *this;
 	}
 	// post-decrement
@@ -657,28 +2305,33 @@ public:
 		return old;
 	}
 
-	T& operator* () const { return ptr->data; }
-	T* operator-> () const { return &(ptr->data); }
+	T& operator* () const { return static_cast<Node*>(ptr)->data; }
+	T* operator-> () const { return &static_cast<Node*>(ptr)->data; }
 
 private:
-	std::shared_ptr<Node> ptr;
+	NodeBase* ptr;
 };
 
-template <typename T>
-class tree<T>::const_iterator
+template <typename T, class Policy>
+class tree<T, Policy>::const_iterator : public policyRef<Policy>
 {
-	template <typename T> friend class tree;
+	template <typename U, class P> friend class tree;
 
 public:
 	typedef std::bidirectional_iterator_tag iterator_category;
+	typedef T value_type;
+	typedef std::ptrdiff_t difference_type;
+	typedef const T* pointer;
+	typedef const T& reference;
 
-	const_iterator() { ptr = nullptr; }
-	const_iterator(const std::shared_ptr<Node> p) { ptr = p; }
-	const_iterator(const const_iterator& it) { ptr = it.ptr; }
-	const_iterator(const iterator& it) { ptr = it.ptr; }
+	const_iterator() : ptr(nullptr) { }
+	const_iterator(NodeBase* p, const Policy* s = nullptr) : policyRef<Policy>(s), ptr(p) { }
+	const_iterator(const const_iterator& it) : policyRef<Policy>(it), ptr(it.ptr) { }
+	const_iterator(const iterator& it) : policyRef<Policy>(it), ptr(it.ptr) { }
 
 	const_iterator& operator= (const const_iterator& it)
 	{
+		policyRef<Policy>::operator= (it);
 		ptr = it.ptr;
 		return *this;
 	}
@@ -686,28 +2339,15 @@ public:
 	bool operator== (const const_iterator& it) const { return ptr == it.ptr; }
 	bool operator!= (const const_iterator& it) const { return ptr != it.ptr; }
 	bool operator< (const const_iterator& it) const { return **this < *it; }
-	bool operator> (const const_iterator& it) const { return **this > * it; }
+	bool operator> (const const_iterator& it) const { return **this > *it; }
 	bool operator<= (const const_iterator& it) const { return **this <= *it; }
 	bool operator>= (const const_iterator& it) const { return **this >= *it; }
 
 	// pre-increment
 	const_iterator& operator++ ()
 	{
-		if (ptr->right)
-		{
-			ptr = ptr->right;
-			while (ptr->left)
-				ptr = ptr->left;
-		}
-		else
-		{
-			std::shared_ptr<Node> before;
-
-			do {
-				before = ptr;
-				ptr = ptr->parent;
-			} while (ptr && before == ptr->right);
-		}
+		opScope<Policy> scope(this->policyOf(), OP_ITERATE);
+		ptr = step<true>(ptr, this->policyOf());
 		return *this;
 	}
 	// post-increment
@@ -721,21 +2361,8 @@ public:
 	// pre-decrement
 	const_iterator& operator-- ()
 	{
-		if (ptr->left)
-		{
-			ptr = ptr->left;
-			while (ptr->right) {
-				ptr = ptr->right;
-			}
-		}
-		else
-		{
-			const std::shared_ptr<Node> before;
-			do {
-				before = ptr;
-				ptr = ptr->parent;
-			} while (ptr && before == ptr->left);
-		}
+		opScope<Policy> scope(this->policyOf(), OP_ITERATE);
+		ptr = step<false>(ptr, this->policyOf());
 		return *this;
 	}
 	// post-decrement
@@ -746,32 +2373,39 @@ public:
 		return old;
 	}
 
-	const T& operator* () const { return (const T&)(ptr->data); }
-	const T* operator-> () const { return &(ptr->data); }
+	const T& operator* () const { return static_cast<Node*>(ptr)->data; }
+	const T* operator-> () const { return &static_cast<Node*>(ptr)->data; }
 
 private:
-	std::shared_ptr<Node> ptr;
+	NodeBase* ptr;
 };
 
-template <typename T>
-class tree<T>::reverse_iterator
+template <typename T, class Policy>
+class tree<T, Policy>::reverse_iterator : public policyRef<Policy>
 {
-	template <typename T> friend class tree;
+	template <typename U, class P> friend class tree;
 
 public:
-	reverse_iterator() { ptr = nullptr; }
-	reverse_iterator(std::shared_ptr<Node> p) { ptr = p; }
-	reverse_iterator(const reverse_iterator& it) { ptr = it.ptr; }
+	typedef std::bidirectional_iterator_tag iterator_category;
+	typedef T value_type;
+	typedef std::ptrdiff_t difference_type;
+	typedef T* pointer;
+	typedef T& reference;
+
+	reverse_iterator() : ptr(nullptr) { }
+	reverse_iterator(NodeBase* p, const Policy* s = nullptr) : policyRef<Policy>(s), ptr(p) { }
+	reverse_iterator(const reverse_iterator& it) : policyRef<Policy>(it), ptr(it.ptr) { }
 
 	reverse_iterator& operator= (const reverse_iterator& it)
 	{
+		policyRef<Policy>::operator= (it);
 		ptr = it.ptr;
 		return *this;
 	}
 
 	bool operator== (const reverse_iterator& it) const { return ptr == it.ptr; }
 	bool operator!= (const reverse_iterator& it) const { return ptr != it.ptr; }
-	bool operator< (const reverse_iterator& it) const { return **this > * it; }
+	bool operator< (const reverse_iterator& it) const { return **this > *it; }
 	bool operator> (const reverse_iterator& it) const { return **this < *it; }
 	bool operator<= (const reverse_iterator& it) const { return **this >= *it; }
 	bool operator>= (const reverse_iterator& it) const { return **this <= *it; }
@@ -779,85 +2413,67 @@ public:
 	// pre-increment
 	reverse_iterator& operator++ ()
 	{
-		if (ptr->left)
-		{
-			ptr = ptr->left;
-			while (ptr->right) {
-				ptr = ptr->right;
-			}
-		}
-		else
-		{
-			std::shared_ptr<Node> before;
-			do {
-				before = ptr;
-				ptr = ptr->parent;
-			} while (ptr && before == ptr->left);
-		}
+		opScope<Policy> scope(this->policyOf(), OP_ITERATE);
+		ptr = step<false>(ptr, this->policyOf());
 		return *this;
 	}
 	// post-increment
 	reverse_iterator operator++ (int)
 	{
-		iterator old(*this);
-		--(*this);
+		reverse_iterator old(*this);
+		++(*this);
 		return old;
 	}
 
 	// pre-decrement
 	reverse_iterator& operator-- ()
 	{
-		if (ptr->right)
-		{
-			ptr = ptr->right;
-			while (ptr->left)
-				ptr = ptr->left;
-		}
-		else
-		{
-			std::shared_ptr<Node> before;
-
-			do {
-				before = ptr;
-				ptr = ptr->parent;
-			} while (ptr && before == ptr->right);
-		}
+		opScope<Policy> scope(this->policyOf(), OP_ITERATE);
+		ptr = step<true>(ptr, this->policyOf());
 		return *this;
 	}
 	// post-decrement
 	reverse_iterator operator-- (int)
 	{
 		reverse_iterator old(*this);
-		++(*this);
+		--(*this);
 		return old;
 	}
 
-	T& operator* () const { return ptr->data; }
-	T* operator-> () const { return &(ptr->data); }
+	T& operator* () const { return static_cast<Node*>(ptr)->data; }
+	T* operator-> () const { return &static_cast<Node*>(ptr)->data; }
 
 private:
-	std::shared_ptr<Node> ptr;
+	NodeBase* ptr;
 };
 
-template <typename T>
-class tree<T>::const_reverse_iterator
+template <typename T, class Policy>
+class tree<T, Policy>::const_reverse_iterator : public policyRef<Policy>
 {
-	template <typename T> friend class tree;
+	template <typename U, class P> friend class tree;
 
 public:
-	const_reverse_iterator() { ptr = nullptr; }
-	const_reverse_iterator(std::shared_ptr<Node> p) { ptr = p; }
-	const_reverse_iterator(const const_reverse_iterator& it) { ptr = it.ptr; }
+	typedef std::bidirectional_iterator_tag iterator_category;
+	typedef T value_type;
+	typedef std::ptrdiff_t difference_type;
+	typedef const T* pointer;
+	typedef const T& reference;
+
+	const_reverse_iterator() : ptr(nullptr) { }
+	const_reverse_iterator(NodeBase* p, const Policy* s = nullptr) : policyRef<Policy>(s), ptr(p) { }
+	const_reverse_iterator(const const_reverse_iterator& it) : policyRef<Policy>(it), ptr(it.ptr) { }
+	const_reverse_iterator(const reverse_iterator& it) : policyRef<Policy>(it), ptr(it.ptr) { }
 
 	const_reverse_iterator& operator= (const const_reverse_iterator& it)
 	{
+		policyRef<Policy>::operator= (it);
 		ptr = it.ptr;
 		return *this;
 	}
 
 	bool operator== (const const_reverse_iterator& it) const { return ptr == it.ptr; }
 	bool operator!= (const const_reverse_iterator& it) const { return ptr != it.ptr; }
-	bool operator< (const const_reverse_iterator& it) const { return **this > * it; }
+	bool operator< (const const_reverse_iterator& it) const { return **this > *it; }
 	bool operator> (const const_reverse_iterator& it) const { return **this < *it; }
 	bool operator<= (const const_reverse_iterator& it) const { return **this >= *it; }
 	bool operator>= (const const_reverse_iterator& it) const { return **this <= *it; }
@@ -865,64 +2481,38 @@ public:
 	// pre-increment
 	const_reverse_iterator& operator++ ()
 	{
-		if (ptr->left)
-		{
-			ptr = ptr->left;
-			while (ptr->right) {
-				ptr = ptr->right;
-			}
-		}
-		else
-		{
-			std::shared_ptr<Node> before;
-			do {
-				before = ptr;
-				ptr = ptr->parent;
-			} while (ptr && before == ptr->left);
-		}
+		opScope<Policy> scope(this->policyOf(), OP_ITERATE);
+		ptr = step<false>(ptr, this->policyOf());
 		return *this;
 	}
 	// post-increment
 	const_reverse_iterator operator++ (int)
 	{
 		const_reverse_iterator old(*this);
-		--(*this);
+		++(*this);
 		return old;
 	}
 
 	// pre-decrement
 	const_reverse_iterator& operator-- ()
 	{
-		if (ptr->right)
-		{
-			ptr = ptr->right;
-			while (ptr->left)
-				ptr = ptr->left;
-		}
-		else
-		{
-			std::shared_ptr<Node> before;
-
-			do {
-				before = ptr;
-				ptr = ptr->parent;
-			} while (ptr && before == ptr->right);
-		}
+		opScope<Policy> scope(this->policyOf(), OP_ITERATE);
+		ptr = step<true>(ptr, this->policyOf());
 		return *this;
 	}
 	// post-decrement
 	const_reverse_iterator operator-- (int)
 	{
 		const_reverse_iterator old(*this);
-		++(*this);
+		--(*this);
 		return old;
 	}
 
-	T& operator* () const { return ptr->data; }
-	T* operator-> () const { return &(ptr->data); }
+	const T& operator* () const { return static_cast<Node*>(ptr)->data; }
+	const T* operator-> () const { return &static_cast<Node*>(ptr)->data; }
 
 private:
-	std::shared_ptr<Node> ptr;
+	NodeBase* ptr;
 };
 
 #endif
@@ -13,48 +13,61 @@
 *************************************************************************
 * Change Log:
 *  10/26/2018: Initial release. JME
+*  10/18/2026: Added reserve.
+*  10/18/2026: Copy constructor and assignment copy from rhs, clear frees
+*              storage.
+*  10/18/2026: Elements constructed in place in raw storage, so T needs no
+*              default constructor; pop_back destroys the last element.
 *************************************************************************/
 #ifndef _MY_VECTOR_H_
 #define _MY_VECTOR_H_
 
-#include <memory> // unique pointer
+#include <memory>  // allocator.
+#include <new>     // placement new.
+#include <utility> // move.
 
 template<typename T>
 class Vector
 {
-	std::size_t count;         // Number of actually stored objects.
-	std::size_t capacity;      // Allocated capacity.
-	std::unique_ptr<T[]> data; // Data element.
+	std::size_t count;    // Number of actually stored objects.
+	std::size_t capacity; // Allocated capacity.
+	T* data;              // Storage, the first count objects constructed.
 
 public:
 	// Default ctor.
 	Vector() : count(0), capacity(0), data(nullptr) { };
 	// Copy ctor.
-	Vector(Vector const &rhs) : count(rhs.count), capacity(rhs.capacity), data(nullptr)
+	Vector(Vector const &rhs) : count(0), capacity(0), data(nullptr)
 	{
-		std::unique_ptr<T[]> data = std::make_unique<T[]>(capacity);
-
-		for (std::size_t i = 0; i < count; i++)
-			data[i] = rhs.data[i];
+		reserve(rhs.capacity);
+		for (std::size_t i = 0; i < rhs.count; i++)
+			push_back(rhs.data[i]);
 	};
 
 	// Dtor.
-	~Vector() { };
+	~Vector() { clear(); };
 	
 	// Clear.
-	void clear() { data.release(); };
+	void clear()
+	{
+		while (count)
+			data[--count].~T();
+		if (data)
+			std::allocator<T>().deallocate(data, capacity);
+		data = nullptr;
+		capacity = 0;
+	};
 
 	// Provides memory management.
 	Vector &operator= (Vector const &rhs)
 	{
-		std::unique_ptr<T[]> temp(static_cast<T*>(data.release()));
+		if (this == &rhs)
+			return *this;
 
-		count = rhs.count;
-		capacity = rhs.capacity;
-		data.reset(new T[capacity]);
-		
-		for (std::size_t i = 0; i < count; i++)
-			data[i] = temp[i];
+		clear();
+		reserve(rhs.capacity);
+		for (std::size_t i = 0; i < rhs.count; i++)
+			push_back(rhs.data[i]);
 
 		return *this;
 	};
@@ -63,16 +76,30 @@ public:
 	void push_back(T const &d)
 	{
 		if (capacity == count)
+		{
+			// d may be one of ours, copied before the storage moves.
+			T copy(d);
 			resize();
-		data[count++] = d;
+			new (data + count) T(std::move(copy));
+		}
+		else
+			new (data + count) T(d);
+		count++;
 	};
 
-	// Decrements count, doesn't actually remove value from array.
+	// Removes last value.
 	void pop_back()
 	{
 		if (count == 0)
 			return;
-		count--;
+		data[--count].~T();
+	};
+
+	// Ensure capacity for at least n elements.
+	void reserve(std::size_t n)
+	{
+		if (n > capacity)
+			resize(n);
 	};
 
 	// Size getter.
@@ -83,16 +110,22 @@ public:
 	T &operator[] (size_t i) { return data[i]; };
 
 private:
-	// Allocates double old size.
-	void resize()
+	// Allocates double old size (or n if given).
+	void resize(std::size_t n = 0)
 	{
-		capacity = capacity ? capacity*2 : 1;
+		std::size_t grown = n ? n : (capacity ? capacity*2 : 1);
 
-		std::unique_ptr<T[]> temp(static_cast<T*>(data.release()));
-		data.reset(new T[capacity]);
-		// Copy old to new.
+		T* temp = std::allocator<T>().allocate(grown);
+		// Move old to new.
 		for (std::size_t i = 0; i < count; i++)
-			data[i] = temp[i];
+		{
+			new (temp + i) T(std::move(data[i]));
+			data[i].~T();
+		}
+		if (data)
+			std::allocator<T>().deallocate(data, capacity);
+		data = temp;
+		capacity = grown;
 	};
 };
 